@@ -0,0 +1,98 @@
+#include <cmath>
+#include "bounds.h"
+
+namespace Geometry {
+
+    namespace Bounds {
+
+        AABB Sphere (
+            const Vec<3> &sphere_center,
+            const float_max_t &sphere_radius
+        ) {
+            const Vec<3> radius(sphere_radius);
+            return AABB(sphere_center - radius, sphere_center + radius);
+        }
+
+        AABB Box (
+            const Vec<3> &box_min,
+            const Vec<3> &box_max
+        ) {
+            return AABB().extend(box_min).extend(box_max);
+        }
+
+        // The caps are discs, a disc of normal n spans radius * sqrt(1 - n[i] ^ 2) along axis i
+        AABB Cylinder (
+            const Vec<3> &cylinder_bottom,
+            const Vec<3> &cylinder_delta,
+            const float_max_t &cylinder_height2,
+            const float_max_t &cylinder_radius
+        ) {
+            Vec<3> extent;
+            for (unsigned i = 0; i < 3; ++i) {
+                const float_max_t axis2 = cylinder_delta[i] * cylinder_delta[i] / cylinder_height2;
+                extent[i] = cylinder_radius * std::sqrt(std::max<float_max_t>(0.0, 1.0 - axis2));
+            }
+
+            const Vec<3> cylinder_top = cylinder_bottom + cylinder_delta;
+            AABB result;
+            result.extend(cylinder_bottom - extent).extend(cylinder_bottom + extent);
+            result.extend(cylinder_top - extent).extend(cylinder_top + extent);
+            return result;
+        }
+
+        // Every vertex is where three planes meet and no other plane cuts it off
+        AABB Polyhedron (
+            const std::vector<Geometry::Plane> &planes
+        ) {
+            AABB result;
+            const unsigned size = planes.size();
+
+            for (unsigned i = 0; i < size; ++i) {
+                const Vec<3> &n_i = planes[i].getNormal();
+                for (unsigned j = i + 1; j < size; ++j) {
+                    const Vec<3> &n_j = planes[j].getNormal();
+                    for (unsigned k = j + 1; k < size; ++k) {
+                        const Vec<3> &n_k = planes[k].getNormal();
+                        const Vec<3> jk = n_j.cross(n_k);
+                        const float_max_t denom = n_i.dot(jk);
+
+                        if (closeToZero(denom)) {
+                            continue;
+                        }
+
+                        const Vec<3> vertex = (
+                            jk * planes[i].getD() +
+                            n_k.cross(n_i) * planes[j].getD() +
+                            n_i.cross(n_j) * planes[k].getD()
+                        ) / denom;
+
+                        bool inside = true;
+                        for (unsigned l = 0; l < size && inside; ++l) {
+                            const float_max_t d = planes[l].getD();
+                            inside = planes[l].getNormal().dot(vertex) - d <= EPSILON * std::max<float_max_t>(1.0, std::abs(d));
+                        }
+                        if (inside) {
+                            result.extend(vertex);
+                        }
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        AABB Polyhedron (
+            const ConvexPolyhedron &polyhedron
+        ) {
+            return Polyhedron(polyhedron.toPlanes());
+        }
+
+        AABB Triangle (
+            const Vec<3> &triangle_vertex_0,
+            const Vec<3> &triangle_vertex_1,
+            const Vec<3> &triangle_vertex_2
+        ) {
+            return AABB().extend(triangle_vertex_0).extend(triangle_vertex_1).extend(triangle_vertex_2);
+        }
+    };
+};
@@ -0,0 +1,112 @@
+#ifndef MODULE_GRAPHICS_GEOMETRY_BOUNDS_H_
+#define MODULE_GRAPHICS_GEOMETRY_BOUNDS_H_
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include "defaults.h"
+#include "vec.h"
+#include "plane.h"
+#include "convex_polyhedron.h"
+#include "cylinder.h"
+
+namespace Geometry {
+
+    // Axis aligned bounding box, empty (min above max) until something is added to it
+    class AABB {
+
+        Vec<3> min, max;
+
+    public:
+
+        AABB (void) :
+            min(std::numeric_limits<float_max_t>::infinity()), max(-std::numeric_limits<float_max_t>::infinity()) {}
+
+        AABB (const Vec<3> &_min, const Vec<3> &_max) : min(_min), max(_max) {}
+
+        inline const Vec<3> &getMin (void) const { return this->min; }
+        inline const Vec<3> &getMax (void) const { return this->max; }
+
+        inline Vec<3> getCenter (void) const { return (this->min + this->max) * 0.5; }
+        inline Vec<3> getExtent (void) const { return this->max - this->min; }
+
+        inline bool isEmpty (void) const { return this->min[0] > this->max[0] || this->min[1] > this->max[1] || this->min[2] > this->max[2]; }
+
+        inline bool contains (const Vec<3> &point) const {
+            return this->min[0] <= point[0] && point[0] <= this->max[0] &&
+                this->min[1] <= point[1] && point[1] <= this->max[1] &&
+                this->min[2] <= point[2] && point[2] <= this->max[2];
+        }
+
+        inline AABB &extend (const Vec<3> &point) {
+            for (unsigned i = 0; i < 3; ++i) {
+                this->min[i] = std::min(this->min[i], point[i]);
+                this->max[i] = std::max(this->max[i], point[i]);
+            }
+            return *this;
+        }
+
+        inline AABB &extend (const AABB &other) {
+            for (unsigned i = 0; i < 3; ++i) {
+                this->min[i] = std::min(this->min[i], other.min[i]);
+                this->max[i] = std::max(this->max[i], other.max[i]);
+            }
+            return *this;
+        }
+
+        inline unsigned longestAxis (void) const {
+            const Vec<3> extent = this->getExtent();
+            return extent[0] >= extent[1] ? (extent[0] >= extent[2] ? 0 : 2) : (extent[1] >= extent[2] ? 1 : 2);
+        }
+
+        inline float_max_t surfaceArea (void) const {
+            if (this->isEmpty()) {
+                return 0.0;
+            }
+            const Vec<3> extent = this->getExtent();
+            return 2.0 * (extent[0] * extent[1] + extent[1] * extent[2] + extent[2] * extent[0]);
+        }
+    };
+
+    // Bounds of the shapes tested in Intersection::Line, from the same parameters
+    namespace Bounds {
+
+        AABB Sphere (
+            const Vec<3> &sphere_center,
+            const float_max_t &sphere_radius
+        );
+
+        AABB Box (
+            const Vec<3> &box_min,
+            const Vec<3> &box_max
+        );
+
+        AABB Cylinder (
+            const Vec<3> &cylinder_bottom,
+            const Vec<3> &cylinder_delta,
+            const float_max_t &cylinder_height2,
+            const float_max_t &cylinder_radius
+        );
+
+        inline AABB Cylinder (
+            const Geometry::Cylinder &cylinder
+        ) { return Cylinder(cylinder.getBottom(), cylinder.getDelta(), cylinder.getHeight2(), cylinder.getRadius()); }
+
+        // Planes face outwards (inside is normal . x <= d) and should close a bounded volume
+        AABB Polyhedron (
+            const std::vector<Geometry::Plane> &planes
+        );
+
+        AABB Polyhedron (
+            const ConvexPolyhedron &polyhedron
+        );
+
+        AABB Triangle (
+            const Vec<3> &triangle_vertex_0,
+            const Vec<3> &triangle_vertex_1,
+            const Vec<3> &triangle_vertex_2
+        );
+    };
+};
+
+#endif
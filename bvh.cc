@@ -0,0 +1,838 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include "bvh.h"
+#include "intersection_batch.h"
+#include "simd.h"
+#include "slab.h"
+
+namespace Geometry {
+
+    constexpr unsigned BVH::max_leaf_size;
+    constexpr unsigned BVH::max_depth;
+    constexpr unsigned BVH::max_bins;
+
+    unsigned BVH::add (Shape shape, unsigned index, const AABB &primitive_bounds) {
+        this->primitives.push_back({ shape, index });
+        this->bounds.push_back(primitive_bounds);
+        return this->primitives.size() - 1;
+    }
+
+    unsigned BVH::addSphere (
+        const Vec<3> &sphere_center,
+        const float_max_t &sphere_radius
+    ) {
+        this->spheres.push_back({ sphere_center, sphere_radius });
+        return this->add(Shape::Sphere, this->spheres.size() - 1, Bounds::Sphere(sphere_center, sphere_radius));
+    }
+
+    unsigned BVH::addBox (
+        const Vec<3> &box_min,
+        const Vec<3> &box_max
+    ) {
+        this->boxes.push_back({ box_min, box_max });
+        return this->add(Shape::Box, this->boxes.size() - 1, Bounds::Box(box_min, box_max));
+    }
+
+    unsigned BVH::addCylinder (
+        const Vec<3> &cylinder_bottom,
+        const Vec<3> &cylinder_delta,
+        const float_max_t &cylinder_height2,
+        const float_max_t &cylinder_radius
+    ) {
+        this->cylinders.push_back({ cylinder_bottom, cylinder_delta, cylinder_height2, cylinder_radius });
+        return this->add(
+            Shape::Cylinder, this->cylinders.size() - 1,
+            Bounds::Cylinder(cylinder_bottom, cylinder_delta, cylinder_height2, cylinder_radius)
+        );
+    }
+
+    unsigned BVH::addCylinder (
+        const Geometry::Cylinder &cylinder
+    ) {
+        return this->addCylinder(cylinder.getBottom(), cylinder.getDelta(), cylinder.getHeight2(), cylinder.getRadius());
+    }
+
+    unsigned BVH::addPolyhedron (
+        const std::vector<Geometry::Plane> &planes
+    ) {
+        return this->addPolyhedron(ConvexPolyhedron(planes));
+    }
+
+    unsigned BVH::addPolyhedron (
+        const ConvexPolyhedron &polyhedron
+    ) {
+        this->polyhedra.push_back(polyhedron);
+        return this->add(Shape::Polyhedron, this->polyhedra.size() - 1, Bounds::Polyhedron(polyhedron));
+    }
+
+    unsigned BVH::addTriangle (
+        const Vec<3> &triangle_vertex_0,
+        const Vec<3> &triangle_vertex_1,
+        const Vec<3> &triangle_vertex_2
+    ) {
+        this->triangles.push_back({ triangle_vertex_0, triangle_vertex_1, triangle_vertex_2 });
+        return this->add(
+            Shape::Triangle, this->triangles.size() - 1,
+            Bounds::Triangle(triangle_vertex_0, triangle_vertex_1, triangle_vertex_2)
+        );
+    }
+
+    unsigned BVH::addMesh (const Mesh &mesh) {
+        const unsigned first = this->primitives.size(), count = mesh.getTriangleCount();
+        this->triangles.reserve(this->triangles.size() + count);
+        this->primitives.reserve(first + count);
+        this->bounds.reserve(first + count);
+        for (unsigned triangle = 0; triangle < count; ++triangle) {
+            this->addTriangle(mesh.getVertex(triangle, 0), mesh.getVertex(triangle, 1), mesh.getVertex(triangle, 2));
+        }
+        return first;
+    }
+
+    void BVH::clear (void) {
+        this->spheres.clear(), this->boxes.clear(), this->cylinders.clear(), this->polyhedra.clear(), this->triangles.clear();
+        this->primitives.clear(), this->bounds.clear();
+        this->nodes.clear(), this->order.clear();
+        this->leaf_min.clear(), this->leaf_max.clear();
+        this->parents.clear(), this->leaves.clear(), this->positions.clear(), this->depths.clear(), this->moved.clear();
+        this->sah_sum = 0.0, this->stats = BuildStats();
+    }
+
+// -------------------------------------
+
+    unsigned BVH::slot (unsigned primitive, Shape shape) const {
+        if (primitive >= this->primitives.size() || this->primitives[primitive].shape != shape) {
+            throw std::invalid_argument("primitive " + std::to_string(primitive) + " doesn't exist or has another shape");
+        }
+        return this->primitives[primitive].index;
+    }
+
+    void BVH::changed (unsigned primitive, const AABB &primitive_bounds) {
+        this->bounds[primitive] = primitive_bounds;
+        if (primitive < this->moved.size()) {
+            this->moved[primitive] = 1;
+        }
+    }
+
+    void BVH::setSphere (
+        unsigned primitive,
+        const Vec<3> &sphere_center,
+        const float_max_t &sphere_radius
+    ) {
+        this->spheres[this->slot(primitive, Shape::Sphere)] = { sphere_center, sphere_radius };
+        this->changed(primitive, Bounds::Sphere(sphere_center, sphere_radius));
+    }
+
+    void BVH::setBox (
+        unsigned primitive,
+        const Vec<3> &box_min,
+        const Vec<3> &box_max
+    ) {
+        this->boxes[this->slot(primitive, Shape::Box)] = { box_min, box_max };
+        this->changed(primitive, Bounds::Box(box_min, box_max));
+    }
+
+    void BVH::setCylinder (
+        unsigned primitive,
+        const Vec<3> &cylinder_bottom,
+        const Vec<3> &cylinder_delta,
+        const float_max_t &cylinder_height2,
+        const float_max_t &cylinder_radius
+    ) {
+        this->cylinders[this->slot(primitive, Shape::Cylinder)] = { cylinder_bottom, cylinder_delta, cylinder_height2, cylinder_radius };
+        this->changed(primitive, Bounds::Cylinder(cylinder_bottom, cylinder_delta, cylinder_height2, cylinder_radius));
+    }
+
+    void BVH::setCylinder (
+        unsigned primitive,
+        const Geometry::Cylinder &cylinder
+    ) {
+        this->setCylinder(primitive, cylinder.getBottom(), cylinder.getDelta(), cylinder.getHeight2(), cylinder.getRadius());
+    }
+
+    void BVH::setPolyhedron (
+        unsigned primitive,
+        const std::vector<Geometry::Plane> &planes
+    ) {
+        this->setPolyhedron(primitive, ConvexPolyhedron(planes));
+    }
+
+    void BVH::setPolyhedron (
+        unsigned primitive,
+        const ConvexPolyhedron &polyhedron
+    ) {
+        this->polyhedra[this->slot(primitive, Shape::Polyhedron)] = polyhedron;
+        this->changed(primitive, Bounds::Polyhedron(polyhedron));
+    }
+
+    void BVH::setTriangle (
+        unsigned primitive,
+        const Vec<3> &triangle_vertex_0,
+        const Vec<3> &triangle_vertex_1,
+        const Vec<3> &triangle_vertex_2
+    ) {
+        this->triangles[this->slot(primitive, Shape::Triangle)] = { triangle_vertex_0, triangle_vertex_1, triangle_vertex_2 };
+        this->changed(primitive, Bounds::Triangle(triangle_vertex_0, triangle_vertex_1, triangle_vertex_2));
+    }
+
+    void BVH::move (
+        unsigned primitive,
+        const Quaternion &rotation,
+        const Vec<3> &translation,
+        const Vec<3> &pivot
+    ) {
+        if (primitive >= this->primitives.size()) {
+            throw std::invalid_argument("primitive " + std::to_string(primitive) + " doesn't exist");
+        }
+        const Primitive &entry = this->primitives[primitive];
+
+        switch (entry.shape) {
+            case Shape::Sphere: {
+                const Sphere &sphere = this->spheres[entry.index];
+                this->setSphere(primitive, rotation.rotated(sphere.center, pivot) + translation, sphere.radius);
+                break;
+            }
+            case Shape::Box: {
+                const Box &box = this->boxes[entry.index];
+                const Vec<3> half = (box.max - box.min) * 0.5, center = rotation.rotated(box.min + half, pivot) + translation;
+                this->setBox(primitive, center - half, center + half);
+                break;
+            }
+            case Shape::Cylinder: {
+                const Cylinder &cylinder = this->cylinders[entry.index];
+                this->setCylinder(
+                    primitive,
+                    rotation.rotated(cylinder.bottom, pivot) + translation, rotation.rotated(cylinder.delta),
+                    cylinder.height2, cylinder.radius
+                );
+                break;
+            }
+            case Shape::Polyhedron: {
+                // Each face is carried by its point closest to the origin
+                const ConvexPolyhedron &polyhedron = this->polyhedra[entry.index];
+                ConvexPolyhedron moved_polyhedron;
+                for (unsigned face = 0, size = polyhedron.size(); face < size; ++face) {
+                    const Vec<3> face_normal = polyhedron.getNormal(face), normal = rotation.rotated(face_normal);
+                    moved_polyhedron.addFace(normal, normal.dot(rotation.rotated(face_normal * polyhedron.getD(face), pivot) + translation));
+                }
+                this->setPolyhedron(primitive, moved_polyhedron);
+                break;
+            }
+            case Shape::Triangle: {
+                const Triangle &triangle = this->triangles[entry.index];
+                this->setTriangle(
+                    primitive,
+                    rotation.rotated(triangle.vertex_0, pivot) + translation,
+                    rotation.rotated(triangle.vertex_1, pivot) + translation,
+                    rotation.rotated(triangle.vertex_2, pivot) + translation
+                );
+                break;
+            }
+        }
+    }
+
+// -----------------------------------------------------------------------------
+
+    struct BVH::BuildContext {
+        ThreadPool &pool;
+        const BuildOptions &options;
+        std::vector<Vec<3>> centroids;
+        std::atomic<unsigned> node_count, leaf_count, max_depth;
+
+        BuildContext (ThreadPool &_pool, const BuildOptions &_options, unsigned size) :
+            pool(_pool), options(_options), centroids(size), node_count(1), leaf_count(0), max_depth(0) {}
+    };
+
+    BVH::BuildStats BVH::build (void) {
+        return this->build(BuildOptions());
+    }
+
+    BVH::BuildStats BVH::build (const BuildOptions &options) {
+        ThreadPool pool;
+        return this->build(pool, options);
+    }
+
+    BVH::BuildStats BVH::build (ThreadPool &pool) {
+        return this->build(pool, BuildOptions());
+    }
+
+    BVH::BuildStats BVH::build (ThreadPool &pool, const BuildOptions &options) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const unsigned size = this->size();
+
+        BuildContext context(pool, options, size);
+        this->options = options;
+
+        this->order.resize(size);
+        pool.parallelFor(0, size, options.parallel_threshold, [ this, &context ] (std::size_t from, std::size_t to) {
+            for (std::size_t i = from; i < to; ++i) {
+                this->order[i] = i;
+                context.centroids[i] = this->bounds[i].getCenter();
+            }
+        });
+
+        this->nodes.clear();
+        this->leaves.resize(size);
+        this->moved.assign(size, 0);
+        if (size != 0) {
+            this->nodes.resize(2 * size - 1);
+            this->parents.resize(2 * size - 1);
+            this->depths.resize(2 * size - 1);
+            this->parents[0] = static_cast<unsigned>(-1);
+            this->buildNode(context, 0, 0, size, 0);
+            this->nodes.resize(context.node_count);
+        }
+        this->parents.resize(this->nodes.size());
+        this->depths.resize(this->nodes.size());
+
+        // Batch::Box reads whole groups, the padding keeps the last leaf in bounds
+        this->leaf_min.resize(size + Simd::batchWidth<float_max_t>() - 1);
+        this->leaf_max.resize(size + Simd::batchWidth<float_max_t>() - 1);
+        this->positions.resize(size);
+        pool.parallelFor(0, size, options.parallel_threshold, [ this ] (std::size_t from, std::size_t to) {
+            for (std::size_t i = from; i < to; ++i) {
+                this->positions[this->order[i]] = i;
+                const AABB &primitive_bounds = this->bounds[this->order[i]];
+                this->leaf_min.set(i, primitive_bounds.getMin());
+                this->leaf_max.set(i, primitive_bounds.getMax());
+            }
+        });
+
+        this->stats.build_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        this->stats.threads = pool.size();
+        this->stats.node_count = this->nodes.size();
+        this->stats.leaf_count = context.leaf_count;
+        this->stats.max_depth = context.max_depth;
+        this->sah_sum = 0.0;
+        for (const Node &node : this->nodes) {
+            this->sah_sum += this->nodeCost(node);
+        }
+        this->stats.sah_cost = size != 0 && this->nodes[0].bounds.surfaceArea() > 0.0 ? this->sah_sum / this->nodes[0].bounds.surfaceArea() : 0.0;
+        this->stats.average_leaf_size = context.leaf_count != 0 ? static_cast<float_max_t>(size) / context.leaf_count : 0.0;
+
+        return this->stats;
+    }
+
+    // Binned SAH over the centroids on the three axes. Nodes too deep, or whose centroids
+    // can't be binned apart, fall back to a median split on the longest centroid axis.
+    void BVH::buildNode (BuildContext &context, unsigned index, unsigned first, unsigned count, unsigned depth) {
+        struct Bin {
+            AABB bounds;
+            unsigned count = 0;
+        };
+        typedef std::array<Bin, 3 * max_bins> Bins;
+
+        const BuildOptions &options = context.options;
+        const unsigned bins = clamp(std::min(options.bins, count), 2u, max_bins);
+        const bool parallel = count >= options.parallel_threshold && context.pool.size() > 1;
+        unsigned *ids = this->order.data() + first;
+
+        AABB node_bounds, centroid_bounds;
+        {
+            std::mutex mutex;
+            const auto gather = [ this, &context, ids, &mutex, &node_bounds, &centroid_bounds ] (std::size_t from, std::size_t to) {
+                AABB local_bounds, local_centroids;
+                for (std::size_t i = from; i < to; ++i) {
+                    local_bounds.extend(this->bounds[ids[i]]);
+                    local_centroids.extend(context.centroids[ids[i]]);
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                node_bounds.extend(local_bounds);
+                centroid_bounds.extend(local_centroids);
+            };
+            if (parallel) {
+                context.pool.parallelFor(0, count, options.parallel_threshold / 4, gather);
+            } else {
+                gather(0, count);
+            }
+        }
+
+        Node &node = this->nodes[index];
+        node.bounds = node_bounds, node.first = first, node.count = count;
+        this->depths[index] = depth;
+
+        const auto leaf = [ this, &context, index, ids, count ] (void) {
+            ++context.leaf_count;
+            for (unsigned i = 0; i < count; ++i) {
+                this->leaves[ids[i]] = index;
+            }
+        };
+
+        unsigned deepest = context.max_depth.load();
+        while (depth > deepest && !context.max_depth.compare_exchange_weak(deepest, depth));
+
+        if (count == 1) {
+            leaf();
+            return;
+        }
+
+        // Every cost is scaled by the node area, which saves a division and copes with flat nodes
+        const Vec<3> centroid_min = centroid_bounds.getMin(), centroid_extent = centroid_bounds.getExtent();
+        const float_max_t node_area = node_bounds.surfaceArea();
+        float_max_t best_cost = std::numeric_limits<float_max_t>::infinity();
+        unsigned best_axis = 3, best_split = 0;
+
+        if (depth < max_depth) {
+            Bins bin;
+            {
+                // One pass over the primitives for the three axes, flat axes being left empty
+                float_max_t scale[3];
+                for (unsigned axis = 0; axis < 3; ++axis) {
+                    scale[axis] = centroid_extent[axis] > 0.0 ? bins / centroid_extent[axis] : 0.0;
+                }
+                const auto fill = [ this, &context, ids, bins, &centroid_min, &scale ] (std::size_t from, std::size_t to, Bins &local) {
+                    for (std::size_t i = from; i < to; ++i) {
+                        const AABB &primitive_bounds = this->bounds[ids[i]];
+                        const float_max_t *centroid = context.centroids[ids[i]].data(), *low = centroid_min.data();
+                        for (unsigned axis = 0; axis < 3; ++axis) {
+                            if (scale[axis] != 0.0) {
+                                Bin &target = local[axis * bins + std::min(bins - 1, static_cast<unsigned>((centroid[axis] - low[axis]) * scale[axis]))];
+                                target.bounds.extend(primitive_bounds);
+                                ++target.count;
+                            }
+                        }
+                    }
+                };
+                if (parallel) {
+                    std::mutex mutex;
+                    context.pool.parallelFor(0, count, options.parallel_threshold / 4, [ &fill, &mutex, &bin, bins ] (std::size_t from, std::size_t to) {
+                        Bins local;
+                        fill(from, to, local);
+                        std::lock_guard<std::mutex> lock(mutex);
+                        for (unsigned b = 0; b < 3 * bins; ++b) {
+                            bin[b].bounds.extend(local[b].bounds);
+                            bin[b].count += local[b].count;
+                        }
+                    });
+                } else {
+                    fill(0, count, bin);
+                }
+            }
+
+            std::array<float_max_t, max_bins> right_area;
+            std::array<unsigned, max_bins> right_count;
+            for (unsigned axis = 0; axis < 3; ++axis) {
+                if (centroid_extent[axis] <= 0.0) {
+                    continue;
+                }
+                const Bin *axis_bin = bin.data() + axis * bins;
+
+                AABB right;
+                unsigned right_total = 0;
+                for (unsigned b = bins - 1; b > 0; --b) {
+                    right.extend(axis_bin[b].bounds);
+                    right_total += axis_bin[b].count;
+                    right_area[b] = right.surfaceArea();
+                    right_count[b] = right_total;
+                }
+
+                AABB left;
+                unsigned left_total = 0;
+                for (unsigned b = 1; b < bins; ++b) {
+                    left.extend(axis_bin[b - 1].bounds);
+                    left_total += axis_bin[b - 1].count;
+                    if (left_total == 0 || right_count[b] == 0) {
+                        continue;
+                    }
+                    const float_max_t cost =
+                        options.traversal_cost * node_area +
+                        options.intersection_cost * (left.surfaceArea() * left_total + right_area[b] * right_count[b]);
+                    if (cost < best_cost) {
+                        best_cost = cost, best_axis = axis, best_split = b;
+                    }
+                }
+            }
+        }
+
+        if (count <= max_leaf_size && (best_axis == 3 || options.intersection_cost * count * node_area <= best_cost)) {
+            leaf();
+            return;
+        }
+
+        unsigned middle = 0;
+        if (best_axis != 3) {
+            const float_max_t scale = bins / centroid_extent[best_axis];
+            const float_max_t low = centroid_min[best_axis];
+            middle = std::partition(ids, ids + count, [ &context, best_axis, best_split, bins, scale, low ] (unsigned id) {
+                return std::min(bins - 1, static_cast<unsigned>((context.centroids[id][best_axis] - low) * scale)) < best_split;
+            }) - ids;
+        }
+        if (middle == 0 || middle == count) {
+            const unsigned axis = centroid_bounds.longestAxis();
+            middle = count / 2;
+            std::nth_element(ids, ids + middle, ids + count, [ &context, axis ] (unsigned a, unsigned b) {
+                return context.centroids[a][axis] < context.centroids[b][axis];
+            });
+        }
+
+        const unsigned children = context.node_count.fetch_add(2);
+        node.first = children, node.count = 0;
+        this->parents[children] = this->parents[children + 1] = index;
+
+        if (parallel) {
+            ThreadPool::Group group;
+            context.pool.run(group, [ this, &context, children, first, middle, depth ] (void) {
+                this->buildNode(context, children, first, middle, depth + 1);
+            });
+            this->buildNode(context, children + 1, first + middle, count - middle, depth + 1);
+            context.pool.wait(group);
+        } else {
+            this->buildNode(context, children, first, middle, depth + 1);
+            this->buildNode(context, children + 1, first + middle, count - middle, depth + 1);
+        }
+    }
+
+// -----------------------------------------------------------------------------
+
+    BVH::RefitStats BVH::refit (void) {
+        ThreadPool pool;
+        return this->refit(pool);
+    }
+
+    // Moved leaves flag every node up to the root, stopping at nodes already flagged. Flagged
+    // nodes are then recomputed one depth at a time, deepest first, so children are always done.
+    BVH::RefitStats BVH::refit (ThreadPool &pool) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const unsigned size = this->moved.size(), node_count = this->nodes.size(), grain = this->options.parallel_threshold;
+
+        std::vector<std::atomic<unsigned char>> dirty(node_count);
+        for (std::atomic<unsigned char> &flag : dirty) {
+            flag.store(0, std::memory_order_relaxed);
+        }
+
+        std::atomic<unsigned> moved_count(0);
+        pool.parallelFor(0, size, grain, [ this, &dirty, &moved_count ] (std::size_t from, std::size_t to) {
+            unsigned local_count = 0;
+            for (std::size_t i = from; i < to; ++i) {
+                if (!this->moved[i]) {
+                    continue;
+                }
+                this->moved[i] = 0, ++local_count;
+                this->leaf_min.set(this->positions[i], this->bounds[i].getMin());
+                this->leaf_max.set(this->positions[i], this->bounds[i].getMax());
+                for (unsigned node = this->leaves[i]; node != static_cast<unsigned>(-1) && !dirty[node].exchange(1); node = this->parents[node]) {}
+            }
+            moved_count += local_count;
+        });
+
+        std::vector<std::vector<unsigned>> levels(max_depth + 32);
+        unsigned refitted = 0;
+        for (unsigned node = 0; node < node_count; ++node) {
+            if (dirty[node].load(std::memory_order_relaxed)) {
+                levels[this->depths[node]].push_back(node);
+                ++refitted;
+            }
+        }
+
+        std::mutex mutex;
+        for (unsigned depth = levels.size(); depth-- > 0; ) {
+            const std::vector<unsigned> &level = levels[depth];
+            pool.parallelFor(0, level.size(), grain, [ this, &level, &mutex ] (std::size_t from, std::size_t to) {
+                float_max_t delta = 0.0;
+                for (std::size_t i = from; i < to; ++i) {
+                    Node &node = this->nodes[level[i]];
+                    delta -= this->nodeCost(node);
+
+                    AABB node_bounds;
+                    if (node.isLeaf()) {
+                        for (unsigned j = node.first; j < node.first + node.count; ++j) {
+                            node_bounds.extend(this->bounds[this->order[j]]);
+                        }
+                    } else {
+                        node_bounds.extend(this->nodes[node.first].bounds).extend(this->nodes[node.first + 1].bounds);
+                    }
+                    node.bounds = node_bounds;
+
+                    delta += this->nodeCost(node);
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                this->sah_sum += delta;
+            });
+        }
+
+        RefitStats result;
+        const float_max_t root_area = node_count != 0 ? this->nodes[0].bounds.surfaceArea() : 0.0;
+        result.threads = pool.size();
+        result.moved_count = moved_count;
+        result.node_count = refitted;
+        result.sah_cost = root_area > 0.0 ? this->sah_sum / root_area : 0.0;
+        result.degradation = this->stats.sah_cost > 0.0 ? result.sah_cost / this->stats.sah_cost : 1.0;
+        result.needs_rebuild = result.degradation > this->options.rebuild_threshold || this->size() != size;
+        result.refit_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        return result;
+    }
+
+// -----------------------------------------------------------------------------
+
+    float_max_t BVH::enter (const AABB &box, const Ray &ray) {
+        const float_max_t
+            *point = ray.getPoint().data(),
+            *inv_direction = ray.getInverseDirection().data(),
+            *bounds[2] = { box.getMin().data(), box.getMax().data() };
+        const std::array<unsigned char, 3> &sign = ray.getSign();
+
+        float_max_t mu_min = ray.getTMin(), mu_max = ray.getTMax();
+        for (unsigned i = 0; i < 3; ++i) {
+            Intersection::Slab<float_max_t>(
+                (bounds[sign[i]][i] - point[i]) * inv_direction[i],
+                (bounds[1 - sign[i]][i] - point[i]) * inv_direction[i],
+                mu_min, mu_max
+            );
+        }
+
+        return mu_min <= mu_max ? mu_min : std::numeric_limits<float_max_t>::infinity();
+    }
+
+    BVH::Hit BVH::intersect (unsigned primitive, const Ray &ray) const {
+        const Primitive &entry = this->primitives[primitive];
+        const Vec<3> &point = ray.getPoint(), &direction = ray.getDirection();
+
+        Hit result = {};
+        float_max_t t_min = 0.0, t_max = 0.0;
+
+        switch (entry.shape) {
+            case Shape::Sphere: {
+                const Sphere &sphere = this->spheres[entry.index];
+                result.sphere = Intersection::Line::Sphere(point, direction, sphere.center, sphere.radius);
+                result.hit = result.sphere.hit, t_min = result.sphere.t_min, t_max = result.sphere.t_max;
+                break;
+            }
+            case Shape::Box: {
+                const Box &box = this->boxes[entry.index];
+                result.box = Intersection::Line::Box(ray, box.min, box.max);
+                result.hit = result.box.hit, t_min = result.box.t_min, t_max = result.box.t_max;
+                break;
+            }
+            case Shape::Cylinder: {
+                const Cylinder &cylinder = this->cylinders[entry.index];
+                result.cylinder = Intersection::Line::Cylinder(point, direction, cylinder.bottom, cylinder.delta, cylinder.height2, cylinder.radius);
+                result.hit = result.cylinder.hit, t_min = result.cylinder.t_min, t_max = result.cylinder.t_max;
+                break;
+            }
+            case Shape::Polyhedron: {
+                result.polyhedron = Intersection::Line::Polyhedron(ray, this->polyhedra[entry.index]);
+                result.hit = result.polyhedron.hit, t_min = result.polyhedron.t_min, t_max = result.polyhedron.t_max;
+                break;
+            }
+            case Shape::Triangle: {
+                const Triangle &triangle = this->triangles[entry.index];
+                result.triangle = Intersection::Line::Triangle(point, direction, triangle.vertex_0, triangle.vertex_1, triangle.vertex_2);
+                result.hit = result.triangle.hit, t_min = t_max = result.triangle.t;
+                break;
+            }
+        }
+
+        result.primitive = primitive;
+        result.shape = entry.shape;
+
+        if (result.hit) {
+            if (ray.contains(t_min)) {
+                result.t = t_min;
+            } else if (ray.contains(t_max)) {
+                result.t = t_max;
+            } else {
+                result.hit = false;
+            }
+        }
+
+        return result;
+    }
+
+    bool BVH::any (unsigned primitive, const Ray &ray) const {
+        const Primitive &entry = this->primitives[primitive];
+
+        switch (entry.shape) {
+            case Shape::Sphere: {
+                const Sphere &sphere = this->spheres[entry.index];
+                return Intersection::Any::Sphere(ray, sphere.center, sphere.radius);
+            }
+            case Shape::Box: {
+                const Box &box = this->boxes[entry.index];
+                return Intersection::Any::Box(ray, box.min, box.max);
+            }
+            case Shape::Cylinder: {
+                const Cylinder &cylinder = this->cylinders[entry.index];
+                return Intersection::Any::Cylinder(ray, cylinder.bottom, cylinder.delta, cylinder.height2, cylinder.radius);
+            }
+            case Shape::Polyhedron: {
+                return Intersection::Any::Polyhedron(ray, this->polyhedra[entry.index]);
+            }
+            case Shape::Triangle: {
+                const Triangle &triangle = this->triangles[entry.index];
+                return Intersection::Any::Triangle(ray, triangle.vertex_0, triangle.vertex_1, triangle.vertex_2);
+            }
+        }
+
+        return false;
+    }
+
+// -----------------------------------------------------------------------------
+
+    // Nearest child first. visit(primitive) gets every primitive whose bounds the probe crosses,
+    // may shrink the probe interval (nodes entered past its end are then skipped) and returns
+    // false to stop.
+    template <typename VISIT>
+    void BVH::traverse (Ray &probe, const VISIT &visit) const {
+        struct Entry {
+            unsigned node;
+            float_max_t t;
+        };
+
+        if (this->nodes.empty()) {
+            return;
+        }
+
+        alignas(32) std::array<float_max_t, max_leaf_size + Simd::batchWidth<float_max_t>() - 1> t_min;
+        // Median splits past max_depth keep the depth under max_depth + 32
+        std::array<Entry, max_depth + 32> stack;
+        unsigned top = 0;
+
+        const float_max_t t_root = enter(this->nodes[0].bounds, probe);
+        if (t_root != std::numeric_limits<float_max_t>::infinity()) {
+            stack[top++] = { 0, t_root };
+        }
+
+        while (top != 0) {
+            const Entry &entry = stack[--top];
+            if (entry.t > probe.getTMax()) {
+                continue;
+            }
+            const Node &node = this->nodes[entry.node];
+
+            if (node.isLeaf()) {
+                std::uint64_t mask = Intersection::Batch::Box(
+                    probe,
+                    { this->leaf_min.lane(0) + node.first, this->leaf_min.lane(1) + node.first, this->leaf_min.lane(2) + node.first },
+                    { this->leaf_max.lane(0) + node.first, this->leaf_max.lane(1) + node.first, this->leaf_max.lane(2) + node.first },
+                    node.count,
+                    t_min.data()
+                );
+                for (unsigned lane = 0; mask != 0; ++lane, mask >>= 1) {
+                    if ((mask & 1u) && !visit(this->order[node.first + lane])) {
+                        return;
+                    }
+                }
+                continue;
+            }
+
+            const unsigned near = node.first, far = node.first + 1;
+            const float_max_t
+                t_near = enter(this->nodes[near].bounds, probe),
+                t_far = enter(this->nodes[far].bounds, probe);
+            const bool
+                hit_near = t_near != std::numeric_limits<float_max_t>::infinity(),
+                hit_far = t_far != std::numeric_limits<float_max_t>::infinity();
+
+            if (hit_near && hit_far) {
+                const bool swap = t_far < t_near;
+                stack[top++] = swap ? Entry({ near, t_near }) : Entry({ far, t_far });
+                stack[top++] = swap ? Entry({ far, t_far }) : Entry({ near, t_near });
+            } else if (hit_near) {
+                stack[top++] = { near, t_near };
+            } else if (hit_far) {
+                stack[top++] = { far, t_far };
+            }
+        }
+    }
+
+    // Whether the hit is the entry or the exit follows from which of t_min and t_max it is
+    Vec<3> BVH::getNormal (const Ray &ray, const Hit &hit) const {
+        const Primitive &entry = this->primitives[hit.primitive];
+        const Vec<3> point = ray.at(hit.t);
+
+        switch (entry.shape) {
+            case Shape::Sphere: {
+                const Sphere &sphere = this->spheres[entry.index];
+                return (point - sphere.center) / sphere.radius;
+            }
+            case Shape::Box: {
+                const bool entering = hit.t == hit.box.t_min;
+                const unsigned axis = entering ? hit.box.axis_t_min : hit.box.axis_t_max;
+                const bool box_min = entering ? hit.box.is_t_min_box_min : hit.box.is_t_max_box_min;
+                Vec<3> result = Vec<3>::zero;
+                result[axis] = box_min ? -1.0 : 1.0;
+                return result;
+            }
+            case Shape::Cylinder: {
+                const Cylinder &cylinder = this->cylinders[entry.index];
+                const bool entering = hit.t == hit.cylinder.t_min;
+                const bool cap = entering ?
+                    hit.cylinder.is_t_min_top_cap || hit.cylinder.is_t_min_bottom_cap :
+                    hit.cylinder.is_t_max_top_cap || hit.cylinder.is_t_max_bottom_cap;
+                const float_max_t height = (point - cylinder.bottom).dot(cylinder.delta) / cylinder.height2;
+                if (cap) {
+                    return cylinder.delta.normalized() * (height < 0.5 ? -1.0 : 1.0);
+                }
+                return (point - cylinder.bottom - cylinder.delta * height).normalized();
+            }
+            case Shape::Polyhedron: {
+                const bool entering = hit.t == hit.polyhedron.t_min;
+                return this->polyhedra[entry.index].getNormal(entering ? hit.polyhedron.face_min : hit.polyhedron.face_max);
+            }
+            case Shape::Triangle: {
+                const Triangle &triangle = this->triangles[entry.index];
+                const Vec<3> normal = (triangle.vertex_1 - triangle.vertex_0).cross(triangle.vertex_2 - triangle.vertex_0).normalized();
+                return normal.dot(ray.getDirection()) > 0.0 ? Vec<3>(-normal) : normal;
+            }
+        }
+
+        return Vec<3>::zero;
+    }
+
+    // The ray interval shrinks to the closest hit found so far
+    BVH::Hit BVH::closest (const Ray &ray) const {
+        Hit result = {};
+        Ray probe(ray);
+
+        this->traverse(probe, [ this, &ray, &probe, &result ] (unsigned primitive) {
+            const Hit hit = this->intersect(primitive, probe);
+            if (hit && (!result || hit.t < result.t)) {
+                result = hit;
+                probe.setInterval(ray.getTMin(), hit.t);
+            }
+            return true;
+        });
+
+        return result;
+    }
+
+    bool BVH::any (const Ray &ray) const {
+        bool result = false;
+        Ray probe(ray);
+
+        this->traverse(probe, [ this, &probe, &result ] (unsigned primitive) {
+            result = this->any(primitive, probe);
+            return !result;
+        });
+
+        return result;
+    }
+
+    void BVH::all (const Ray &ray, const std::function<bool(const Hit &)> &callback) const {
+        Ray probe(ray);
+
+        this->traverse(probe, [ this, &probe, &callback ] (unsigned primitive) {
+            const Hit hit = this->intersect(primitive, probe);
+            return !hit || callback(hit);
+        });
+    }
+
+    unsigned BVH::all (const Ray &ray, std::vector<Hit> &hits) const {
+        const std::size_t first = hits.size();
+
+        this->all(ray, [ &hits ] (const Hit &hit) {
+            hits.push_back(hit);
+            return true;
+        });
+
+        std::sort(hits.begin() + first, hits.end(), [] (const Hit &a, const Hit &b) { return a.t < b.t; });
+        return hits.size() - first;
+    }
+};
@@ -0,0 +1,268 @@
+#ifndef MODULE_GRAPHICS_GEOMETRY_BVH_H_
+#define MODULE_GRAPHICS_GEOMETRY_BVH_H_
+
+#include <vector>
+#include <functional>
+#include "defaults.h"
+#include "vec.h"
+#include "vec_array.h"
+#include "plane.h"
+#include "convex_polyhedron.h"
+#include "cylinder.h"
+#include "ray.h"
+#include "quaternion.h"
+#include "bounds.h"
+#include "intersection.h"
+#include "mesh.h"
+#include "thread_pool.h"
+
+namespace Geometry {
+
+    // Bounding volume hierarchy over spheres, boxes, cylinders, plane-set polyhedra and triangles,
+    // taking the same parameters as Intersection::Line. Primitives are added, then build() is called
+    // before querying. Leaves keep their primitive bounds lane by lane for Batch::Box.
+    // Moving primitives with the set and move methods, then calling refit(), updates the
+    // tree without rebuilding it, until RefitStats::needs_rebuild says the tree got too loose.
+    // NOTE Wald, On fast Construction of SAH-based Bounding Volume Hierarchies (binned SAH)
+    class BVH {
+
+    public:
+
+        enum class Shape : unsigned char { Sphere, Box, Cylinder, Polyhedron, Triangle };
+
+        // Closest hit: t is the first of t_min and t_max inside the ray interval, and the record of
+        // the primitive's shape carries the usual axis, cap, face or barycentric information.
+        struct Hit {
+            float_max_t t;
+            unsigned primitive;
+            Shape shape;
+            union {
+                Intersection::SphereHit sphere;
+                Intersection::BoxHit box;
+                Intersection::CylinderHit cylinder;
+                Intersection::PolyhedronHit polyhedron;
+                Intersection::TriangleHit triangle;
+            };
+            bool hit;
+
+            inline explicit operator bool (void) const { return this->hit; }
+        };
+
+        struct BuildOptions {
+            // Per axis, nodes of fewer primitives using one bin per primitive
+            unsigned bins = 16;
+            float_max_t traversal_cost = 2.0, intersection_cost = 1.0;
+            // Subtrees smaller than this are built by a single task
+            unsigned parallel_threshold = 4096;
+            // refit() asks for a rebuild once the SAH cost grows past this factor of the built one
+            float_max_t rebuild_threshold = 1.5;
+        };
+
+        // Costs use the surface area heuristic, relative to the root bounds
+        struct BuildStats {
+            double build_time;
+            unsigned threads, node_count, leaf_count, max_depth;
+            float_max_t sah_cost, average_leaf_size;
+        };
+
+        // degradation is sah_cost over the cost right after the last build
+        struct RefitStats {
+            double refit_time;
+            unsigned threads, moved_count, node_count;
+            float_max_t sah_cost, degradation;
+            bool needs_rebuild;
+        };
+
+        static constexpr unsigned max_leaf_size = 8, max_depth = 48, max_bins = 32;
+
+    private:
+
+        // Inner nodes keep their children next to each other, starting at `first`
+        struct Node {
+            AABB bounds;
+            unsigned first, count;
+
+            inline bool isLeaf (void) const { return this->count != 0; }
+        };
+
+        struct Sphere { Vec<3> center; float_max_t radius; };
+        struct Box { Vec<3> min, max; };
+        struct Cylinder { Vec<3> bottom, delta; float_max_t height2, radius; };
+        struct Triangle { Vec<3> vertex_0, vertex_1, vertex_2; };
+        struct Primitive { Shape shape; unsigned index; };
+
+        std::vector<Sphere> spheres;
+        std::vector<Box> boxes;
+        std::vector<Cylinder> cylinders;
+        std::vector<ConvexPolyhedron> polyhedra;
+        std::vector<Triangle> triangles;
+
+        std::vector<Primitive> primitives;
+        std::vector<AABB> bounds;
+
+        std::vector<Node> nodes;
+        std::vector<unsigned> order;
+        VecArray<3> leaf_min, leaf_max;
+        BuildOptions options;
+        BuildStats stats;
+
+        // Refit bookkeeping: parent and depth of every node, leaf and leaf position of every
+        // primitive, and a flag per primitive set when it moves, so threads moving different
+        // primitives never write to the same place
+        std::vector<unsigned> parents, leaves, positions;
+        std::vector<unsigned char> depths, moved;
+        float_max_t sah_sum;
+
+        struct BuildContext;
+
+        unsigned add (Shape shape, unsigned index, const AABB &primitive_bounds);
+        void buildNode (BuildContext &context, unsigned index, unsigned first, unsigned count, unsigned depth);
+        unsigned slot (unsigned primitive, Shape shape) const;
+        void changed (unsigned primitive, const AABB &primitive_bounds);
+
+        inline float_max_t nodeCost (const Node &node) const {
+            return node.bounds.surfaceArea() * (node.isLeaf() ? this->options.intersection_cost * node.count : this->options.traversal_cost);
+        }
+
+        static float_max_t enter (const AABB &box, const Ray &ray);
+
+        template <typename VISIT>
+        void traverse (Ray &probe, const VISIT &visit) const;
+
+    public:
+
+        BVH (void) : stats(), sah_sum(0.0) {}
+
+        unsigned addSphere (
+            const Vec<3> &sphere_center,
+            const float_max_t &sphere_radius
+        );
+
+        unsigned addBox (
+            const Vec<3> &box_min,
+            const Vec<3> &box_max
+        );
+
+        unsigned addCylinder (
+            const Vec<3> &cylinder_bottom,
+            const Vec<3> &cylinder_delta,
+            const float_max_t &cylinder_height2,
+            const float_max_t &cylinder_radius
+        );
+
+        unsigned addCylinder (
+            const Geometry::Cylinder &cylinder
+        );
+
+        // Kept packed, as a ConvexPolyhedron
+        unsigned addPolyhedron (
+            const std::vector<Geometry::Plane> &planes
+        );
+
+        unsigned addPolyhedron (
+            const ConvexPolyhedron &polyhedron
+        );
+
+        unsigned addTriangle (
+            const Vec<3> &triangle_vertex_0,
+            const Vec<3> &triangle_vertex_1,
+            const Vec<3> &triangle_vertex_2
+        );
+
+        // Every triangle of the mesh, in order, as consecutive primitives. Returns the first one.
+        unsigned addMesh (const Mesh &mesh);
+
+        void clear (void);
+
+        // Without a pool, one is created for the build with a thread per hardware thread
+        BuildStats build (void);
+        BuildStats build (const BuildOptions &options);
+        BuildStats build (ThreadPool &pool);
+        BuildStats build (ThreadPool &pool, const BuildOptions &options);
+
+        // Same parameters as the add methods. The shape of a primitive can't change.
+        void setSphere (
+            unsigned primitive,
+            const Vec<3> &sphere_center,
+            const float_max_t &sphere_radius
+        );
+
+        void setBox (
+            unsigned primitive,
+            const Vec<3> &box_min,
+            const Vec<3> &box_max
+        );
+
+        void setCylinder (
+            unsigned primitive,
+            const Vec<3> &cylinder_bottom,
+            const Vec<3> &cylinder_delta,
+            const float_max_t &cylinder_height2,
+            const float_max_t &cylinder_radius
+        );
+
+        void setCylinder (
+            unsigned primitive,
+            const Geometry::Cylinder &cylinder
+        );
+
+        void setPolyhedron (
+            unsigned primitive,
+            const std::vector<Geometry::Plane> &planes
+        );
+
+        void setPolyhedron (
+            unsigned primitive,
+            const ConvexPolyhedron &polyhedron
+        );
+
+        void setTriangle (
+            unsigned primitive,
+            const Vec<3> &triangle_vertex_0,
+            const Vec<3> &triangle_vertex_1,
+            const Vec<3> &triangle_vertex_2
+        );
+
+        // Rotates around pivot, then translates. Boxes stay axis aligned: only their center follows the rotation.
+        void move (
+            unsigned primitive,
+            const Quaternion &rotation,
+            const Vec<3> &translation,
+            const Vec<3> &pivot = Vec<3>::zero
+        );
+
+        // Updates the bounds of the nodes above moved primitives, level by level from the leaves.
+        // Primitives added since the last build aren't in the tree, and make needs_rebuild true.
+        RefitStats refit (void);
+        RefitStats refit (ThreadPool &pool);
+
+        inline unsigned size (void) const { return this->primitives.size(); }
+        inline bool empty (void) const { return this->primitives.empty(); }
+        inline Shape getShape (unsigned primitive) const { return this->primitives[primitive].shape; }
+        inline const AABB &getBounds (unsigned primitive) const { return this->bounds[primitive]; }
+        inline AABB getBounds (void) const { return this->nodes.empty() ? AABB() : this->nodes[0].bounds; }
+        inline unsigned getNodeCount (void) const { return this->nodes.size(); }
+        inline const BuildStats &getStats (void) const { return this->stats; }
+
+        // Single primitive, without going through the tree
+        Hit intersect (unsigned primitive, const Ray &ray) const;
+        bool any (unsigned primitive, const Ray &ray) const;
+
+        Hit closest (const Ray &ray) const;
+
+        // Unit outward normal of the surface where a hit of the ray lies, from its axis, cap or face.
+        // Triangles are hit from both sides, their normal facing the ray.
+        Vec<3> getNormal (const Ray &ray, const Hit &hit) const;
+
+        // Whether anything is hit inside the ray interval, stopping at the first hit found
+        bool any (const Ray &ray) const;
+
+        // Every primitive hit inside the ray interval, as closest() would report it. The callback
+        // sees them in traversal order and returns false to stop. The buffer version appends them
+        // sorted by t and returns how many were added.
+        void all (const Ray &ray, const std::function<bool(const Hit &)> &callback) const;
+        unsigned all (const Ray &ray, std::vector<Hit> &hits) const;
+    };
+};
+
+#endif
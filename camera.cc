@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <cmath>
+#include "camera.h"
+#include "simd.h"
+
+namespace Geometry {
+
+    // An up direction along the view falls back to any perpendicular one
+    void Camera::update (void) {
+        this->right = this->direction.cross(this->up_dir);
+        if (this->right.length2() < EPSILON) {
+            this->right = this->direction.perpendicular();
+        }
+        this->right.normalize();
+        this->up = this->right.cross(this->direction);
+
+        const float_max_t
+            half_height = std::tan(this->fov * 0.5),
+            half_width = half_height * this->width / this->height;
+
+        this->pixel_right = this->right * (2.0 * half_width / this->width);
+        this->pixel_down = this->up * (-2.0 * half_height / this->height);
+        this->corner = this->direction - this->right * half_width + this->up * half_height;
+    }
+
+    // Simd::batchWidth pixels at a time, the rest one by one so rows never write past x_end
+    void Camera::row (unsigned y, unsigned x_begin, unsigned x_end, float_max_t *const out[3]) const {
+        constexpr unsigned width = Simd::batchWidth<float_max_t>();
+        typedef Simd::Lanes<float_max_t, width> Lanes;
+
+        const Vec<3> start = this->corner + this->pixel_down * (y + 0.5);
+        const float_max_t *base = start.data(), *step = this->pixel_right.data();
+
+        alignas(32) float_max_t offsets[width];
+        for (unsigned lane = 0; lane < width; ++lane) {
+            offsets[lane] = lane + 0.5;
+        }
+        const Lanes lane_offsets = Lanes::load(offsets), one = Lanes::broadcast(1.0);
+
+        unsigned x = x_begin;
+        for (; x + width <= x_end; x += width) {
+            const Lanes pixel = Lanes::broadcast(static_cast<float_max_t>(x)) + lane_offsets;
+            Lanes direction[3];
+            for (unsigned i = 0; i < 3; ++i) {
+                direction[i] = Lanes::broadcast(base[i]) + Lanes::broadcast(step[i]) * pixel;
+            }
+            const Lanes inv_length = one / sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+            for (unsigned i = 0; i < 3; ++i) {
+                (direction[i] * inv_length).store(out[i] + (x - x_begin));
+            }
+        }
+        for (; x < x_end; ++x) {
+            const float_max_t pixel = x + 0.5;
+            float_max_t direction[3];
+            for (unsigned i = 0; i < 3; ++i) {
+                direction[i] = base[i] + step[i] * pixel;
+            }
+            const float_max_t inv_length = 1.0 / std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+            for (unsigned i = 0; i < 3; ++i) {
+                out[i][x - x_begin] = direction[i] * inv_length;
+            }
+        }
+    }
+
+// -----------------------------------------------------------------------------
+
+    ConvexPolyhedron Camera::getFrustum (float_max_t near, float_max_t far) const {
+        return this->getFrustum(static_cast<float_max_t>(this->width) / this->height, near, far);
+    }
+
+    // The side faces hold the position and the edges of the image, seen through the unit vectors
+    // they are tilted from the view direction by tan(fov / 2) (times the aspect for left and right)
+    ConvexPolyhedron Camera::getFrustum (float_max_t aspect, float_max_t near, float_max_t far) const {
+        const float_max_t half_height = std::tan(this->fov * 0.5), half_width = half_height * aspect;
+        const Vec<3> &forward = this->direction;
+        const float_max_t distance = forward.dot(this->position);
+
+        ConvexPolyhedron result;
+        result.addFace(-forward, -(distance + near));
+        result.addFace(forward, distance + far);
+
+        const Vec<3> sides[4] = {
+            (-this->right - forward * half_width).normalized(),
+            (this->right - forward * half_width).normalized(),
+            (this->up - forward * half_height).normalized(),
+            (-this->up - forward * half_height).normalized()
+        };
+        for (const Vec<3> &normal : sides) {
+            result.addFace(normal, normal.dot(this->position));
+        }
+        return result;
+    }
+
+    void Camera::getRays (VecArray<3> &directions) const {
+        ThreadPool pool;
+        this->getRays(directions, pool);
+    }
+
+    void Camera::getRays (VecArray<3> &directions, ThreadPool &pool) const {
+        directions.resize(static_cast<std::size_t>(this->width) * this->height);
+        pool.parallelFor(0, this->height, 8, [ this, &directions ] (std::size_t from, std::size_t to) {
+            for (std::size_t y = from; y < to; ++y) {
+                const std::size_t first = y * this->width;
+                float_max_t *const out[3] = { directions.lane(0) + first, directions.lane(1) + first, directions.lane(2) + first };
+                this->row(y, 0, this->width, out);
+            }
+        });
+    }
+
+    void Camera::forEachTile (unsigned tile_size, const std::function<void(const Tile &, const VecArray<3> &)> &function) const {
+        ThreadPool pool;
+        this->forEachTile(tile_size, function, pool);
+    }
+
+    // Tiles are taken one at a time, as their cost varies, each generated into the directions of
+    // its task right before use, while still in cache
+    void Camera::forEachTile (unsigned tile_size, const std::function<void(const Tile &, const VecArray<3> &)> &function, ThreadPool &pool) const {
+        tile_size = std::max(1u, tile_size);
+        const unsigned
+            columns = (this->width + tile_size - 1) / tile_size,
+            rows = (this->height + tile_size - 1) / tile_size;
+
+        pool.parallelForDynamic(0, static_cast<std::size_t>(columns) * rows, 1, [ this, tile_size, columns, &function ] (std::size_t from, std::size_t to) {
+            VecArray<3> directions;
+            for (std::size_t index = from; index < to; ++index) {
+                Tile tile;
+                tile.x = static_cast<unsigned>(index % columns) * tile_size;
+                tile.y = static_cast<unsigned>(index / columns) * tile_size;
+                tile.width = std::min(tile_size, this->width - tile.x);
+                tile.height = std::min(tile_size, this->height - tile.y);
+
+                directions.resize(static_cast<std::size_t>(tile.width) * tile.height);
+                for (unsigned y = 0; y < tile.height; ++y) {
+                    const std::size_t first = static_cast<std::size_t>(y) * tile.width;
+                    float_max_t *const out[3] = { directions.lane(0) + first, directions.lane(1) + first, directions.lane(2) + first };
+                    this->row(tile.y + y, tile.x, tile.x + tile.width, out);
+                }
+                function(tile, directions);
+            }
+        });
+    }
+};
@@ -1,34 +1,83 @@
 #ifndef MODULE_GEOMETRY_CAMERA_H_
 #define MODULE_GEOMETRY_CAMERA_H_
 
+#include <functional>
 #include "defaults.h"
 #include "vec.h"
+#include "vec_array.h"
 #include "quaternion.h"
+#include "convex_polyhedron.h"
+#include "ray.h"
+#include "thread_pool.h"
 
 namespace Geometry {
 
+    // Pinhole camera over a width x height image, the field of view (in radians) being vertical.
+    // The orthonormal basis and the image plane steps are kept up to date by every setter, so
+    // rays cost a few multiply-adds and a normalization each.
     class Camera {
         Geometry::Vec<3> position, look_at, up_dir, direction;
         float_max_t fov;
+        unsigned width, height;
+
+        // Unit right and up of the image, and the direction through its top left corner stepped
+        // by pixel_right and pixel_down for every pixel, the last three not normalized
+        Geometry::Vec<3> right, up, corner, pixel_right, pixel_down;
+
+        void update (void);
+
+        void row (unsigned y, unsigned x_begin, unsigned x_end, float_max_t *const out[3]) const;
 
     public:
-        Camera (void) {}
 
-        Camera (const Vec<3> &_position, const Vec<3> &_look_at, const Vec<3> &_up_dir, const float_max_t &_fov) :
-            position(_position), look_at(_look_at), up_dir(_up_dir), direction((_look_at - _position).normalized()), fov(_fov) {}
+        // Part of the image, the rays of which come lane by lane in rows of width rays
+        struct Tile {
+            unsigned x, y, width, height;
+        };
+
+        Camera (void) : Camera(Vec<3>::origin, { 0.0, 0.0, -1.0 }, Vec<3>::axisY, DEG90) {}
+
+        Camera (const Vec<3> &_position, const Vec<3> &_look_at, const Vec<3> &_up_dir, const float_max_t &_fov, unsigned _width = 1, unsigned _height = 1) :
+            position(_position), look_at(_look_at), up_dir(_up_dir), direction((_look_at - _position).normalized()), fov(_fov), width(_width), height(_height) { this->update(); }
 
         inline const Geometry::Vec<3> &getPosition (void) const { return this->position; }
         inline const Geometry::Vec<3> &getLookAt (void) const { return this->look_at; }
         inline const Geometry::Vec<3> &getUpDirection (void) const { return this->up_dir; }
         inline const float_max_t &getFieldOfView (void) const { return this->fov; }
         inline const Geometry::Vec<3> &getDirection (void) const { return this->direction; }
+        inline unsigned getWidth (void) const { return this->width; }
+        inline unsigned getHeight (void) const { return this->height; }
+
+        // Unit vectors, right and up as seen on the image
+        inline const Geometry::Vec<3> &getRight (void) const { return this->right; }
+        inline const Geometry::Vec<3> &getUp (void) const { return this->up; }
+
+        inline void setPosition (const Geometry::Vec<3> &_position) { this->position = _position, this->direction = (this->getLookAt() - _position).normalized(), this->update(); }
+        inline void lookAt (const Geometry::Vec<3> &_look_at) { this->look_at = _look_at, this->direction = (_look_at - this->getPosition()).normalized(), this->update(); }
+        inline void setUpDirection (const Geometry::Vec<3> &_up_dir) { this->up_dir = _up_dir.normalized(), this->update(); }
+        inline void setFieldOfView (const float_max_t &_fov) { this->fov = _fov, this->update(); }
+        inline void setResolution (unsigned _width, unsigned _height) { this->width = _width, this->height = _height, this->update(); }
+
+        inline void rotate (const Geometry::Quaternion &rot) { rot.rotate(this->look_at, this->getPosition()), this->direction = (this->look_at - this->getPosition()).normalized(), this->update(); }
+
+        // The volume seen between the near and far distances, faces in the order near, far, left,
+        // right, top and bottom. Without an aspect ratio (width / height), the one of the image.
+        ConvexPolyhedron getFrustum (float_max_t near, float_max_t far) const;
+        ConvexPolyhedron getFrustum (float_max_t aspect, float_max_t near, float_max_t far) const;
+
+        // Image coordinates, pixel (x, y) spanning [x, x + 1) x [y, y + 1) from the top left corner
+        inline Ray getRay (float_max_t x, float_max_t y) const { return Ray(this->position, this->corner + this->pixel_right * x + this->pixel_down * y); }
 
-        inline void setPosition (const Geometry::Vec<3> &_position) { this->position = _position, this->direction = (this->getLookAt() - _position).normalized(); }
-        inline void lookAt (const Geometry::Vec<3> &_look_at) { this->look_at = _look_at, this->direction = (_look_at - this->getPosition()).normalized(); }
-        inline void setUpDirection (const Geometry::Vec<3> &_up_dir) { this->up_dir = _up_dir.normalized(); }
-        inline void setFieldOfView (const float_max_t &_fov) { this->fov = _fov; }
+        // Through the center of every pixel, row after row, the point being the camera position.
+        // The directions are unit, written rows in parallel.
+        void getRays (VecArray<3> &directions) const;
+        void getRays (VecArray<3> &directions, ThreadPool &pool) const;
 
-        inline void rotate (const Geometry::Quaternion &rot) { rot.rotate(this->look_at, this->getPosition()), this->direction = (this->look_at - this->getPosition()).normalized(); }
+        // Tiles of at most tile_size x tile_size pixels are handed out to the threads, each
+        // calling function(tile, directions) with the directions of that tile only, row after row.
+        // Tiles run concurrently, the function must be safe to call from several threads.
+        void forEachTile (unsigned tile_size, const std::function<void(const Tile &, const VecArray<3> &)> &function) const;
+        void forEachTile (unsigned tile_size, const std::function<void(const Tile &, const VecArray<3> &)> &function, ThreadPool &pool) const;
     };
 }
 
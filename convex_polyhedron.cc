@@ -0,0 +1,41 @@
+#include "convex_polyhedron.h"
+#include "simd.h"
+
+namespace Geometry {
+
+    ConvexPolyhedron::ConvexPolyhedron (const std::vector<Geometry::Plane> &planes) : count(planes.size()) {
+        this->pad();
+        for (unsigned face = 0; face < this->count; ++face) {
+            this->normals.set(face, planes[face].getNormal());
+            this->d[face] = planes[face].getD();
+        }
+    }
+
+    void ConvexPolyhedron::pad (void) {
+        const unsigned padded = this->count + Simd::batchWidth<float_max_t>() - 1;
+        this->normals.resize(padded);
+        this->d.resize(padded, 0.0);
+    }
+
+    unsigned ConvexPolyhedron::addFace (const Vec<3> &normal, float_max_t face_d) {
+        const unsigned face = this->count++;
+        this->pad();
+        this->normals.set(face, normal.normalized());
+        this->d[face] = face_d;
+        return face;
+    }
+
+    void ConvexPolyhedron::clear (void) {
+        this->normals.clear(), this->d.clear();
+        this->count = 0;
+    }
+
+    std::vector<Geometry::Plane> ConvexPolyhedron::toPlanes (void) const {
+        std::vector<Geometry::Plane> result;
+        result.reserve(this->count);
+        for (unsigned face = 0; face < this->count; ++face) {
+            result.emplace_back(this->normals.get(face), this->d[face], Geometry::Plane::Lazy());
+        }
+        return result;
+    }
+};
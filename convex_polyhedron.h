@@ -0,0 +1,59 @@
+#ifndef MODULE_GRAPHICS_GEOMETRY_CONVEX_POLYHEDRON_H_
+#define MODULE_GRAPHICS_GEOMETRY_CONVEX_POLYHEDRON_H_
+
+#include <vector>
+#include "defaults.h"
+#include "vec.h"
+#include "vec_array.h"
+#include "plane.h"
+
+namespace Geometry {
+
+    // Half-space form of a convex polyhedron, as the std::vector<Plane> taken by Intersection::Line::Polyhedron
+    // (faces face outwards, inside is normal . x <= d), keeping only the unit normals and d lane by lane:
+    // four values per face instead of a whole Plane, which the polyhedron tests clip Simd::batchWidth faces at a time.
+    class ConvexPolyhedron {
+
+        // Followed by Simd::batchWidth - 1 faces of zero normal and d, which contain everything
+        VecArray<3> normals;
+        std::vector<float_max_t> d;
+        unsigned count;
+
+        void pad (void);
+
+    public:
+
+        ConvexPolyhedron (void) : count(0) {}
+
+        explicit ConvexPolyhedron (const std::vector<Geometry::Plane> &planes);
+
+        // The normal is normalized, as in Plane
+        unsigned addFace (const Vec<3> &normal, float_max_t face_d);
+
+        void clear (void);
+
+        inline unsigned size (void) const { return this->count; }
+        inline bool empty (void) const { return this->count == 0; }
+
+        inline Vec<3> getNormal (unsigned face) const { return this->normals.get(face); }
+        inline float_max_t getD (unsigned face) const { return this->d[face]; }
+
+        // Lanes of count faces, readable up to count rounded up to Simd::batchWidth
+        inline const float_max_t *getNormals (unsigned component) const { return this->normals.lane(component); }
+        inline const float_max_t *getDs (void) const { return this->d.data(); }
+
+        inline bool contains (const Vec<3> &point, float_max_t tolerance = EPSILON) const {
+            for (unsigned face = 0; face < this->count; ++face) {
+                if (this->normals.get(face).dot(point) - this->d[face] > tolerance) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Lazy planes, see Plane
+        std::vector<Geometry::Plane> toPlanes (void) const;
+    };
+};
+
+#endif
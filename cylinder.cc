@@ -0,0 +1,79 @@
+#include <cmath>
+#include "cylinder.h"
+#include "quaternion.h"
+
+namespace Geometry {
+
+    Cylinder::Cylinder (
+        const Vec<3> &_bottom,
+        const Vec<3> &_direction,
+        float_max_t _height,
+        float_max_t _radius
+    ) : bottom(_bottom), direction(_direction.normalized()), height(_height), radius(_radius) {
+        this->update();
+    }
+
+    void Cylinder::setBottom (const Vec<3> &_bottom) {
+        this->bottom = _bottom;
+        this->update();
+    }
+
+    void Cylinder::setDirection (const Vec<3> &_direction) {
+        this->direction = _direction.normalized();
+        this->update();
+    }
+
+    void Cylinder::setHeight (float_max_t _height) {
+        this->height = _height;
+        this->update();
+    }
+
+    void Cylinder::setRadius (float_max_t _radius) {
+        this->radius = _radius;
+        this->update();
+    }
+
+    // The same quaternion as Parametric::Cylinder, so both agree on the frame
+    void Cylinder::update (void) {
+        this->delta = this->direction * this->height;
+        this->height2 = this->height * this->height;
+        this->radius2 = this->radius * this->radius;
+
+        const Quaternion rotation = Quaternion::difference(this->direction, Vec<3>::axisZ);
+        if (rotation.isIdentity()) {
+            this->to_local = { 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0 };
+        } else {
+            this->to_local = rotation.rotation();
+        }
+        const Vec<3> origin = this->toLocalDirection(this->bottom);
+        this->to_local[12] = -origin[0], this->to_local[13] = -origin[1], this->to_local[14] = -origin[2];
+    }
+
+// -----------------------------------------------------------------------------
+
+    // The rotation is orthonormal, its inverse is its transpose
+    Vec<3> Cylinder::fromLocal (const Vec<3> &point) const {
+        const float_max_t *p = point.data(), *m = this->to_local.data(), *b = this->bottom.data();
+        return {
+            p[0] * m[0] + p[1] * m[1] + p[2] * m[ 2] + b[0],
+            p[0] * m[4] + p[1] * m[5] + p[2] * m[ 6] + b[1],
+            p[0] * m[8] + p[1] * m[9] + p[2] * m[10] + b[2]
+        };
+    }
+
+    Vec<2> Cylinder::param (const Vec<3> &point) const {
+        const Vec<3> local = this->toLocal(point);
+        const float_max_t *l = local.data();
+        const float_max_t u = std::atan2(l[1], l[0]) * this->radius;
+        if (l[2] > EPSILON && l[2] < (this->height - EPSILON)) {
+            return { u, l[2] };
+        } else {
+            return { u, 0.0 };
+        }
+    }
+
+    Vec<3> Cylinder::at (float_max_t u, float_max_t v) const {
+        const float_max_t angle = u / this->radius;
+        return this->fromLocal({ this->radius * std::cos(angle), this->radius * std::sin(angle), v });
+    }
+};
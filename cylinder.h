@@ -0,0 +1,88 @@
+#ifndef MODULE_GRAPHICS_GEOMETRY_CYLINDER_H_
+#define MODULE_GRAPHICS_GEOMETRY_CYLINDER_H_
+
+#include <array>
+#include "defaults.h"
+#include "vec.h"
+
+namespace Geometry {
+
+    // Finite cylinder, from its bottom point along direction for height. The delta, the squared
+    // height and radius and the rotation taking direction to the z axis (the frame of
+    // Parametric::Cylinder) are computed once per change, not once per query.
+    class Cylinder {
+
+        Vec<3> bottom, direction, delta;
+        float_max_t height, height2, radius, radius2;
+
+        // Same layout as Quaternion::rotation, with the translation taking bottom to the origin
+        std::array<float_max_t, 16> to_local;
+
+        void update (void);
+
+    public:
+
+        Cylinder (void) : Cylinder(Vec<3>::origin, Vec<3>::axisZ, 1.0, 1.0) {}
+
+        // The direction is normalized
+        Cylinder (
+            const Vec<3> &_bottom,
+            const Vec<3> &_direction,
+            float_max_t _height,
+            float_max_t _radius
+        );
+
+        void setBottom (const Vec<3> &_bottom);
+        void setDirection (const Vec<3> &_direction);
+        void setHeight (float_max_t _height);
+        void setRadius (float_max_t _radius);
+
+        inline const Vec<3> &getBottom (void) const { return this->bottom; }
+        inline Vec<3> getTop (void) const { return this->bottom + this->delta; }
+        inline const Vec<3> &getDirection (void) const { return this->direction; }
+
+        // direction * height, the cylinder_delta of Intersection::Line::Cylinder
+        inline const Vec<3> &getDelta (void) const { return this->delta; }
+
+        inline float_max_t getHeight (void) const { return this->height; }
+        inline float_max_t getHeight2 (void) const { return this->height2; }
+        inline float_max_t getRadius (void) const { return this->radius; }
+        inline float_max_t getRadius2 (void) const { return this->radius2; }
+
+        // Local frame: bottom at the origin and direction along the z axis
+        inline Vec<3> toLocal (const Vec<3> &point) const {
+            const float_max_t *p = point.data(), *m = this->to_local.data();
+            return {
+                p[0] * m[0] + p[1] * m[4] + p[2] * m[ 8] + m[12],
+                p[0] * m[1] + p[1] * m[5] + p[2] * m[ 9] + m[13],
+                p[0] * m[2] + p[1] * m[6] + p[2] * m[10] + m[14]
+            };
+        }
+
+        inline Vec<3> toLocalDirection (const Vec<3> &vec) const {
+            const float_max_t *v = vec.data(), *m = this->to_local.data();
+            return {
+                v[0] * m[0] + v[1] * m[4] + v[2] * m[ 8],
+                v[0] * m[1] + v[1] * m[5] + v[2] * m[ 9],
+                v[0] * m[2] + v[1] * m[6] + v[2] * m[10]
+            };
+        }
+
+        Vec<3> fromLocal (const Vec<3> &point) const;
+
+        // Same (u, v) as Parametric::Cylinder: the arc length around the axis and the height
+        // along it, v being 0 off the side
+        Vec<2> param (const Vec<3> &point) const;
+
+        // The point of the side at (u, v)
+        Vec<3> at (float_max_t u, float_max_t v) const;
+
+        inline bool contains (const Vec<3> &point, float_max_t tolerance = EPSILON) const {
+            const Vec<3> local = this->toLocal(point);
+            const float_max_t *l = local.data();
+            return l[2] >= -tolerance && l[2] <= this->height + tolerance && l[0] * l[0] + l[1] * l[1] <= this->radius2 + tolerance;
+        }
+    };
+};
+
+#endif
@@ -3,13 +3,26 @@
 
 #include <iostream>
 #include <cmath>
+#include <type_traits>
 
+// Every module computes in float_max_t. Define MODULE_GRAPHICS_GEOMETRY_SINGLE_PRECISION
+// (for the whole build, every translation unit must agree) to compute in float.
+#ifdef MODULE_GRAPHICS_GEOMETRY_SINGLE_PRECISION
+typedef float float_max_t;
+#else
 typedef double float_max_t;
+#endif
 
 namespace Geometry {
 
+    // Tolerance used by closeTo, closeToZero and the intersection tests, scaled to the precision of TYPE
+    template <typename TYPE>
+    constexpr TYPE epsilon (void) {
+        return std::is_same<TYPE, float>::value ? static_cast<TYPE>(1e-5) : static_cast<TYPE>(1e-10);
+    }
+
     constexpr float_max_t
-        EPSILON = 1e-10,
+        EPSILON = epsilon<float_max_t>(),
         PI = 3.141592653589793238462643383279502884,
         TWO_PI = PI + PI,
         DEG15 = PI / 12.0,
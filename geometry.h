@@ -1,15 +1,31 @@
 #ifndef MODULE_GRAPHICS_GEOMETRY_SPATIAL_H_
 #define MODULE_GRAPHICS_GEOMETRY_SPATIAL_H_
 
+#include "bounds.h"
+#include "bvh.h"
 #include "camera.h"
+#include "convex_polyhedron.h"
+#include "cylinder.h"
 #include "defaults.h"
 #include "intersection.h"
+#include "intersection_batch.h"
 #include "line.h"
+#include "mesh.h"
 #include "parametric.h"
 #include "plane.h"
 #include "poisson_disc.h"
+#include "poisson_disc_stream.h"
 #include "quaternion.h"
+#include "ray.h"
+#include "ray_packet.h"
+#include "renderer.h"
+#include "simd.h"
+#include "slab.h"
+#include "thread_pool.h"
 #include "type_traits.h"
 #include "vec.h"
+#include "vec_array.h"
+#include "vec_expression.h"
+#include "vec_simd.h"
 
 #endif
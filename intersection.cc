@@ -1,24 +1,47 @@
 #include <iostream>
 #include "intersection.h"
+#include "slab.h"
 
 namespace Geometry {
 
     namespace Intersection {
 
-        Geometry::Vec<3> __default_vec_3_;
-        float_max_t __default_float_max_;
-        unsigned __default_unsigned_;
-        bool __default_bool_;
-
         namespace Point {
 
+            bool Point (
+                const Vec<3> &point_1,
+                const Vec<3> &point_2
+            ) {
+                return point_1.distance2(point_2) <= EPSILON;
+            }
+
             bool Point (
                 const Vec<3> &point_1,
                 const Vec<3> &point_2,
                 Vec<3> &closest_point
             ) {
                 closest_point = point_1;
-                return point_1.distance2(point_2) <= EPSILON;
+                return Point(point_1, point_2);
+            }
+
+            bool Line (
+                const Vec<3> &point,
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction
+            ) {
+                Vec<3> intersection_point;
+                float_max_t t_inter;
+                return Line(point, line_point, line_direction, intersection_point, t_inter);
+            }
+
+            bool Line (
+                const Vec<3> &point,
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                Vec<3> &intersection_point
+            ) {
+                float_max_t t_inter;
+                return Line(point, line_point, line_direction, intersection_point, t_inter);
             }
 
             bool Line (
@@ -38,6 +61,15 @@ namespace Geometry {
                 return false;
             }
 
+            bool Plane (
+                const Vec<3> &point,
+                const Vec<3> &plane_normal,
+                const float_max_t &plane_d
+            ) {
+                Vec<3> intersection_point;
+                return Plane(point, plane_normal, plane_d, intersection_point);
+            }
+
             bool Plane (
                 const Vec<3> &point,
                 const Vec<3> &plane_normal,
@@ -74,16 +106,16 @@ namespace Geometry {
                 float_max_t mu_a = 0.0, mu_b = 0.0;
 
                 if (denom != 0.0) {
-                    mu_a = clamp((b * f - c) / denom, 0.0, 1.0);
+                    mu_a = clamp<float_max_t>((b * f - c) / denom, 0.0, 1.0);
                 }
 
                 const float_max_t numer = b * mu_a + f;
 
                 if (numer <= 0.0) {
-                    mu_a = clamp(-c, 0.0, 1.0);
+                    mu_a = clamp<float_max_t>(-c, 0.0, 1.0);
                 } else if (numer >= 1.0) {
                     mu_b = 1.0;
-                    mu_a = clamp(b - c, 0.0, 1.0);
+                    mu_a = clamp<float_max_t>(b - c, 0.0, 1.0);
                 } else {
                     mu_b = numer;
                 }
@@ -93,29 +125,50 @@ namespace Geometry {
                 return true;
             }
 
-            bool Plane (
+            PlaneHit Plane (
                 const Vec<3> &line_point,
                 const Vec<3> &line_direction,
-                const Geometry::Plane &plane,
-                float_max_t &t_inter
+                const Geometry::Plane &plane
             ) {
+                PlaneHit result = {};
                 const Vec<3> &plane_normal = plane.getNormal();
                 const float_max_t dot = plane_normal.dot(line_direction);
                 if (!closeToZero(dot)) {
-                    t_inter = (plane.getD() - plane_normal.dot(line_point)) / dot;
-                    return true;
+                    result.t = (plane.getD() - plane_normal.dot(line_point)) / dot;
+                    result.hit = true;
                 }
-                return false;
+                return result;
             }
 
-            bool Sphere (
+            bool Plane (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Geometry::Plane &plane,
+                float_max_t &t_inter
+            ) {
+                const PlaneHit result = Plane(line_point, line_direction, plane);
+                if (result) {
+                    t_inter = result.t;
+                }
+                return result.hit;
+            }
+
+            PlaneHit Plane (
+                const Ray &ray,
+                const Geometry::Plane &plane
+            ) {
+                PlaneHit result = Plane(ray.getPoint(), ray.getDirection(), plane);
+                result.hit = result.hit && ray.contains(result.t);
+                return result;
+            }
+
+            SphereHit Sphere (
                 const Vec<3> &line_point,
                 const Vec<3> &line_direction,
                 const Vec<3> &sphere_center,
-                const float_max_t &sphere_radius,
-                float_max_t &t_min,
-                float_max_t &t_max
+                const float_max_t &sphere_radius
             ) {
+                SphereHit result = {};
                 const Vec<3> diff = line_point - sphere_center;
                 const float_max_t
                     b = diff.dot(line_direction),
@@ -123,7 +176,7 @@ namespace Geometry {
                     discr = (b * b) - c;
 
                 if (discr < 0.0) {
-                    return false;
+                    return result;
                 }
 
                 const float_max_t
@@ -132,26 +185,48 @@ namespace Geometry {
                     mu_2 = sqrt_discr - b;
 
                 if (mu_1 > mu_2) {
-                    t_min = mu_2, t_max = mu_1;
+                    result.t_min = mu_2, result.t_max = mu_1;
                 } else {
-                    t_min = mu_1, t_max = mu_2;
+                    result.t_min = mu_1, result.t_max = mu_2;
                 }
 
-                return true;
+                result.hit = true;
+                return result;
             }
 
-            bool Box (
+            bool Sphere (
                 const Vec<3> &line_point,
                 const Vec<3> &line_direction,
-                const Vec<3> &box_min,
-                const Vec<3> &box_max,
+                const Vec<3> &sphere_center,
+                const float_max_t &sphere_radius,
+                float_max_t &t_min
+            ) {
+                float_max_t t_max;
+                return Sphere(line_point, line_direction, sphere_center, sphere_radius, t_min, t_max);
+            }
+
+            bool Sphere (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &sphere_center,
+                const float_max_t &sphere_radius,
                 float_max_t &t_min,
-                unsigned &axis_t_min,
-                bool &is_t_min_box_min,
-                float_max_t &t_max,
-                unsigned &axis_t_max,
-                bool &is_t_max_box_min
+                float_max_t &t_max
+            ) {
+                const SphereHit result = Sphere(line_point, line_direction, sphere_center, sphere_radius);
+                if (result) {
+                    t_min = result.t_min, t_max = result.t_max;
+                }
+                return result.hit;
+            }
+
+            BoxHit Box (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &box_min,
+                const Vec<3> &box_max
             ) {
+                BoxHit result = {};
                 float_max_t
                     mu_min = -std::numeric_limits<float_max_t>::infinity(),
                     mu_max = std::numeric_limits<float_max_t>::infinity();
@@ -159,7 +234,7 @@ namespace Geometry {
                 for (unsigned i = 0; i < 3; ++i) {
                     if (closeToZero(line_direction[i])) {
                         if (line_point[i] < box_min[i] || line_point[i] > box_max[i]) {
-                            return false;
+                            return result;
                         }
                     } else {
                         const float_max_t ood = 1.0 / line_direction[i];
@@ -173,39 +248,159 @@ namespace Geometry {
                             t2 = (box_max[i] - line_point[i]) * ood;
                         }
                         if (t1 > mu_min) {
-                            is_t_min_box_min = !inverse;
-                            axis_t_min = i;
+                            result.is_t_min_box_min = !inverse;
+                            result.axis_t_min = i;
                             mu_min = t1;
                         }
                         if (t2 < mu_max) {
-                            is_t_max_box_min = inverse;
-                            axis_t_max = i;
+                            result.is_t_max_box_min = inverse;
+                            result.axis_t_max = i;
                             mu_max = t2;
                         }
                         if (mu_min > mu_max) {
-                            return false;
+                            return result;
                         }
                     }
                 }
 
-                t_min = mu_min, t_max = mu_max;
-                return true;
+                result.t_min = mu_min, result.t_max = mu_max;
+                result.hit = true;
+                return result;
             }
 
-            bool Cylinder (
+            bool Box (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &box_min,
+                const Vec<3> &box_max,
+                float_max_t &t_min
+            ) {
+                unsigned axis_t_min, axis_t_max;
+                bool is_t_min_box_min, is_t_max_box_min;
+                float_max_t t_max;
+                return Box(line_point, line_direction, box_min, box_max, t_min, axis_t_min, is_t_min_box_min, t_max, axis_t_max, is_t_max_box_min);
+            }
+
+            bool Box (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &box_min,
+                const Vec<3> &box_max,
+                float_max_t &t_min,
+                unsigned &axis_t_min
+            ) {
+                bool is_t_min_box_min, is_t_max_box_min;
+                float_max_t t_max;
+                unsigned axis_t_max;
+                return Box(line_point, line_direction, box_min, box_max, t_min, axis_t_min, is_t_min_box_min, t_max, axis_t_max, is_t_max_box_min);
+            }
+
+            bool Box (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &box_min,
+                const Vec<3> &box_max,
+                float_max_t &t_min,
+                unsigned &axis_t_min,
+                bool &is_t_min_box_min
+            ) {
+                float_max_t t_max;
+                unsigned axis_t_max;
+                bool is_t_max_box_min;
+                return Box(line_point, line_direction, box_min, box_max, t_min, axis_t_min, is_t_min_box_min, t_max, axis_t_max, is_t_max_box_min);
+            }
+
+            bool Box (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &box_min,
+                const Vec<3> &box_max,
+                float_max_t &t_min,
+                unsigned &axis_t_min,
+                bool &is_t_min_box_min,
+                float_max_t &t_max
+            ) {
+                unsigned axis_t_max;
+                bool is_t_max_box_min;
+                return Box(line_point, line_direction, box_min, box_max, t_min, axis_t_min, is_t_min_box_min, t_max, axis_t_max, is_t_max_box_min);
+            }
+
+            bool Box (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &box_min,
+                const Vec<3> &box_max,
+                float_max_t &t_min,
+                unsigned &axis_t_min,
+                bool &is_t_min_box_min,
+                float_max_t &t_max,
+                unsigned &axis_t_max
+            ) {
+                bool is_t_max_box_min;
+                return Box(line_point, line_direction, box_min, box_max, t_min, axis_t_min, is_t_min_box_min, t_max, axis_t_max, is_t_max_box_min);
+            }
+
+            bool Box (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &box_min,
+                const Vec<3> &box_max,
+                float_max_t &t_min,
+                unsigned &axis_t_min,
+                bool &is_t_min_box_min,
+                float_max_t &t_max,
+                unsigned &axis_t_max,
+                bool &is_t_max_box_min
+            ) {
+                const BoxHit result = Box(line_point, line_direction, box_min, box_max);
+                if (result) {
+                    t_min = result.t_min, axis_t_min = result.axis_t_min, is_t_min_box_min = result.is_t_min_box_min;
+                    t_max = result.t_max, axis_t_max = result.axis_t_max, is_t_max_box_min = result.is_t_max_box_min;
+                }
+                return result.hit;
+            }
+
+            BoxHit Box (
+                const Ray &ray,
+                const Vec<3> &box_min,
+                const Vec<3> &box_max
+            ) {
+                BoxHit result = {};
+                const float_max_t
+                    *point = ray.getPoint().data(),
+                    *inv_direction = ray.getInverseDirection().data(),
+                    *bounds[2] = { box_min.data(), box_max.data() };
+                const std::array<unsigned char, 3> &sign = ray.getSign();
+
+                float_max_t
+                    mu_min = -std::numeric_limits<float_max_t>::infinity(),
+                    mu_max = std::numeric_limits<float_max_t>::infinity();
+
+                // A zero direction gives infinite slabs (or NaN on the boundary, which Slab ignores)
+                for (unsigned char i = 0; i < 3; ++i) {
+                    Slab<float_max_t, bool, unsigned char>(
+                        (bounds[sign[i]][i] - point[i]) * inv_direction[i],
+                        (bounds[1 - sign[i]][i] - point[i]) * inv_direction[i],
+                        i, !sign[i], sign[i],
+                        mu_min, result.axis_t_min, result.is_t_min_box_min,
+                        mu_max, result.axis_t_max, result.is_t_max_box_min
+                    );
+                }
+
+                result.t_min = mu_min, result.t_max = mu_max;
+                result.hit = ray.overlaps(mu_min, mu_max);
+                return result;
+            }
+
+            CylinderHit Cylinder (
                 const Vec<3> &line_point,
                 const Vec<3> &line_direction,
                 const Vec<3> &cylinder_bottom,
                 const Vec<3> &cylinder_delta,
                 const float_max_t &cylinder_height2,
-                const float_max_t &cylinder_radius,
-                float_max_t &t_min,
-                bool &is_t_min_top_cap,
-                bool &is_t_min_bottom_cap,
-                float_max_t &t_max,
-                bool &is_t_max_top_cap,
-                bool &is_t_max_bottom_cap
+                const float_max_t &cylinder_radius
             ) {
+                CylinderHit result = {};
                 const Vec<3> diff = line_point - cylinder_bottom;
 
                 const float_max_t
@@ -230,7 +425,7 @@ namespace Geometry {
                 if (closeToZero(a)) {
                     intersect = true;
                     if (c > 0.0) {
-                        return false;
+                        return result;
                     }
                     mu_1 = -mn / nn;
                     mu_2 = (nd - mn) / nn;
@@ -241,7 +436,7 @@ namespace Geometry {
                         discr = b * b - a * c;
 
                     if (discr < 0.0) {
-                        return false;
+                        return result;
                     }
 
                     const float_max_t
@@ -275,27 +470,133 @@ namespace Geometry {
                 }
 
                 if (mu_1 > mu_2) {
-                    is_t_min_top_cap = is_mu_2_top_cap, is_t_max_top_cap = is_mu_1_top_cap;
-                    is_t_min_bottom_cap = is_mu_2_bottom_cap, is_t_max_bottom_cap = is_mu_1_bottom_cap;
-                    t_min = mu_2, t_max = mu_1;
+                    result.is_t_min_top_cap = is_mu_2_top_cap, result.is_t_max_top_cap = is_mu_1_top_cap;
+                    result.is_t_min_bottom_cap = is_mu_2_bottom_cap, result.is_t_max_bottom_cap = is_mu_1_bottom_cap;
+                    result.t_min = mu_2, result.t_max = mu_1;
                 } else {
-                    is_t_min_top_cap = is_mu_1_top_cap, is_t_max_top_cap = is_mu_2_top_cap;
-                    is_t_min_bottom_cap = is_mu_1_bottom_cap, is_t_max_bottom_cap = is_mu_2_bottom_cap;
-                    t_min = mu_1, t_max = mu_2;
+                    result.is_t_min_top_cap = is_mu_1_top_cap, result.is_t_max_top_cap = is_mu_2_top_cap;
+                    result.is_t_min_bottom_cap = is_mu_1_bottom_cap, result.is_t_max_bottom_cap = is_mu_2_bottom_cap;
+                    result.t_min = mu_1, result.t_max = mu_2;
                 }
 
-                return intersect;
+                result.hit = intersect;
+                return result;
             }
 
-            bool Polyhedron (
+            bool Cylinder (
                 const Vec<3> &line_point,
                 const Vec<3> &line_direction,
-                const std::vector<Geometry::Plane> &planes,
+                const Vec<3> &cylinder_bottom,
+                const Vec<3> &cylinder_delta,
+                const float_max_t &cylinder_height2,
+                const float_max_t &cylinder_radius,
+                float_max_t &t_min
+            ) {
+                bool is_t_min_top_cap, is_t_min_bottom_cap, is_t_max_top_cap, is_t_max_bottom_cap;
+                float_max_t t_max;
+                return Cylinder(line_point, line_direction, cylinder_bottom, cylinder_delta, cylinder_height2, cylinder_radius, t_min, is_t_min_top_cap, is_t_min_bottom_cap, t_max, is_t_max_top_cap, is_t_max_bottom_cap);
+            }
+
+            bool Cylinder (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &cylinder_bottom,
+                const Vec<3> &cylinder_delta,
+                const float_max_t &cylinder_height2,
+                const float_max_t &cylinder_radius,
                 float_max_t &t_min,
-                unsigned &face_min,
+                bool &is_t_min_top_cap
+            ) {
+                bool is_t_min_bottom_cap, is_t_max_top_cap, is_t_max_bottom_cap;
+                float_max_t t_max;
+                return Cylinder(line_point, line_direction, cylinder_bottom, cylinder_delta, cylinder_height2, cylinder_radius, t_min, is_t_min_top_cap, is_t_min_bottom_cap, t_max, is_t_max_top_cap, is_t_max_bottom_cap);
+            }
+
+            bool Cylinder (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &cylinder_bottom,
+                const Vec<3> &cylinder_delta,
+                const float_max_t &cylinder_height2,
+                const float_max_t &cylinder_radius,
+                float_max_t &t_min,
+                bool &is_t_min_top_cap,
+                bool &is_t_min_bottom_cap
+            ) {
+                float_max_t t_max;
+                bool is_t_max_top_cap, is_t_max_bottom_cap;
+                return Cylinder(line_point, line_direction, cylinder_bottom, cylinder_delta, cylinder_height2, cylinder_radius, t_min, is_t_min_top_cap, is_t_min_bottom_cap, t_max, is_t_max_top_cap, is_t_max_bottom_cap);
+            }
+
+            bool Cylinder (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &cylinder_bottom,
+                const Vec<3> &cylinder_delta,
+                const float_max_t &cylinder_height2,
+                const float_max_t &cylinder_radius,
+                float_max_t &t_min,
+                bool &is_t_min_top_cap,
+                bool &is_t_min_bottom_cap,
+                float_max_t &t_max
+            ) {
+                bool is_t_max_top_cap, is_t_max_bottom_cap;
+                return Cylinder(line_point, line_direction, cylinder_bottom, cylinder_delta, cylinder_height2, cylinder_radius, t_min, is_t_min_top_cap, is_t_min_bottom_cap, t_max, is_t_max_top_cap, is_t_max_bottom_cap);
+            }
+
+            bool Cylinder (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &cylinder_bottom,
+                const Vec<3> &cylinder_delta,
+                const float_max_t &cylinder_height2,
+                const float_max_t &cylinder_radius,
+                float_max_t &t_min,
+                bool &is_t_min_top_cap,
+                bool &is_t_min_bottom_cap,
                 float_max_t &t_max,
-                unsigned &face_max
+                bool &is_t_max_top_cap
+            ) {
+                bool is_t_max_bottom_cap;
+                return Cylinder(line_point, line_direction, cylinder_bottom, cylinder_delta, cylinder_height2, cylinder_radius, t_min, is_t_min_top_cap, is_t_min_bottom_cap, t_max, is_t_max_top_cap, is_t_max_bottom_cap);
+            }
+
+            bool Cylinder (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &cylinder_bottom,
+                const Vec<3> &cylinder_delta,
+                const float_max_t &cylinder_height2,
+                const float_max_t &cylinder_radius,
+                float_max_t &t_min,
+                bool &is_t_min_top_cap,
+                bool &is_t_min_bottom_cap,
+                float_max_t &t_max,
+                bool &is_t_max_top_cap,
+                bool &is_t_max_bottom_cap
+            ) {
+                const CylinderHit result = Cylinder(line_point, line_direction, cylinder_bottom, cylinder_delta, cylinder_height2, cylinder_radius);
+                if (result) {
+                    t_min = result.t_min, is_t_min_top_cap = result.is_t_min_top_cap, is_t_min_bottom_cap = result.is_t_min_bottom_cap;
+                    t_max = result.t_max, is_t_max_top_cap = result.is_t_max_top_cap, is_t_max_bottom_cap = result.is_t_max_bottom_cap;
+                }
+                return result.hit;
+            }
+
+            CylinderHit Cylinder (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Geometry::Cylinder &cylinder
             ) {
+                return Cylinder(line_point, line_direction, cylinder.getBottom(), cylinder.getDelta(), cylinder.getHeight2(), cylinder.getRadius());
+            }
+
+            PolyhedronHit Polyhedron (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const std::vector<Geometry::Plane> &planes
+            ) {
+                PolyhedronHit result = {};
                 float_max_t
                     mu_min = -std::numeric_limits<float_max_t>::infinity(),
                     mu_max = std::numeric_limits<float_max_t>::infinity();
@@ -309,31 +610,386 @@ namespace Geometry {
                         denom = plane_normal.dot(line_direction),
                         dist = plane_d - plane_normal.dot(line_point);
 
+                    // Parallel to the face: the line misses unless it runs inside that plane
                     if (closeToZero(denom)) {
-                        if (dist > 0.0) {
-                            return false;
+                        if (dist < 0.0) {
+                            return result;
                         }
                     } else {
                         const float_max_t t = dist / denom;
                         if (denom < 0.0) {
                             if (t > mu_min) {
-                                face_min = i;
+                                result.face_min = i;
                                 mu_min = t;
                             }
                         } else if (t < mu_max) {
-                            face_max = i;
+                            result.face_max = i;
                             mu_max = t;
                         }
 
                         if (mu_min > mu_max) {
+                            return result;
+                        }
+                    }
+                }
+
+                result.t_min = mu_min, result.t_max = mu_max;
+                result.hit = true;
+                return result;
+            }
+
+            bool Polyhedron (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const std::vector<Geometry::Plane> &planes,
+                float_max_t &t_min
+            ) {
+                unsigned face_min, face_max;
+                float_max_t t_max;
+                return Polyhedron(line_point, line_direction, planes, t_min, face_min, t_max, face_max);
+            }
+
+            bool Polyhedron (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const std::vector<Geometry::Plane> &planes,
+                float_max_t &t_min,
+                unsigned &face_min
+            ) {
+                float_max_t t_max;
+                unsigned face_max;
+                return Polyhedron(line_point, line_direction, planes, t_min, face_min, t_max, face_max);
+            }
+
+            bool Polyhedron (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const std::vector<Geometry::Plane> &planes,
+                float_max_t &t_min,
+                unsigned &face_min,
+                float_max_t &t_max
+            ) {
+                unsigned face_max;
+                return Polyhedron(line_point, line_direction, planes, t_min, face_min, t_max, face_max);
+            }
+
+            bool Polyhedron (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const std::vector<Geometry::Plane> &planes,
+                float_max_t &t_min,
+                unsigned &face_min,
+                float_max_t &t_max,
+                unsigned &face_max
+            ) {
+                const PolyhedronHit result = Polyhedron(line_point, line_direction, planes);
+                if (result) {
+                    t_min = result.t_min, face_min = result.face_min;
+                    t_max = result.t_max, face_max = result.face_max;
+                }
+                return result.hit;
+            }
+
+            PolyhedronHit Polyhedron (
+                const Ray &ray,
+                const std::vector<Geometry::Plane> &planes
+            ) {
+                PolyhedronHit result = Polyhedron(ray.getPoint(), ray.getDirection(), planes);
+                result.hit = result.hit && ray.overlaps(result.t_min, result.t_max);
+                return result;
+            }
+
+            // Every lane keeps the entry and exit of its own faces, with the first face giving them,
+            // and the lanes are merged at the end: the largest entry and smallest exit, the lowest
+            // face on ties, as the scalar loop picks them
+            PolyhedronHit Polyhedron (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const ConvexPolyhedron &polyhedron
+            ) {
+                constexpr unsigned width = Simd::batchWidth<float_max_t>();
+                typedef Simd::Lanes<float_max_t, width> Lanes;
+
+                PolyhedronHit result = {};
+                const float_max_t
+                    *point = line_point.data(),
+                    *direction = line_direction.data(),
+                    *normal[3] = { polyhedron.getNormals(0), polyhedron.getNormals(1), polyhedron.getNormals(2) },
+                    *plane_d = polyhedron.getDs();
+
+                alignas(32) static const float_max_t lane_face[8] = { 0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0 };
+                static_assert(width <= 8, "Polyhedron lane faces should cover the batch width.");
+
+                const Lanes
+                    zero = Lanes::broadcast(0.0),
+                    epsilon = Lanes::broadcast(EPSILON),
+                    minus_epsilon = Lanes::broadcast(-EPSILON),
+                    step = Lanes::broadcast(width);
+
+                Lanes
+                    point_lanes[3], direction_lanes[3],
+                    face = Lanes::load(lane_face),
+                    mu_min = Lanes::broadcast(-std::numeric_limits<float_max_t>::infinity()),
+                    mu_max = Lanes::broadcast(std::numeric_limits<float_max_t>::infinity()),
+                    face_min = zero, face_max = zero;
+
+                for (unsigned i = 0; i < 3; ++i) {
+                    point_lanes[i] = Lanes::broadcast(point[i]);
+                    direction_lanes[i] = Lanes::broadcast(direction[i]);
+                }
+
+                for (unsigned first = 0, size = polyhedron.size(); first < size; first += width, face = face + step) {
+                    Lanes denom = zero, dist = Lanes::load(plane_d + first);
+                    for (unsigned i = 0; i < 3; ++i) {
+                        const Lanes normal_lanes = Lanes::load(normal[i] + first);
+                        denom = denom + normal_lanes * direction_lanes[i];
+                        dist = dist - normal_lanes * point_lanes[i];
+                    }
+
+                    // Parallel to a face and outside of it: missed
+                    if (((denom >= minus_epsilon) & (denom <= epsilon) & (dist < zero)).bits() != 0) {
+                        return result;
+                    }
+
+                    const Lanes
+                        t = dist / denom,
+                        is_min = (denom < minus_epsilon) & (t > mu_min),
+                        is_max = (denom > epsilon) & (t < mu_max);
+
+                    mu_min = Simd::select(is_min, t, mu_min), face_min = Simd::select(is_min, face, face_min);
+                    mu_max = Simd::select(is_max, t, mu_max), face_max = Simd::select(is_max, face, face_max);
+
+                    // An empty lane empties the merged interval too
+                    if ((mu_min > mu_max).bits() != 0) {
+                        return result;
+                    }
+                }
+
+                const float_max_t t_min = Simd::horizontalMax(mu_min), t_max = Simd::horizontalMin(mu_max);
+                if (t_min > t_max) {
+                    return result;
+                }
+
+                // Lowest face among the lanes reaching t_min and t_max
+                const Lanes infinity = Lanes::broadcast(std::numeric_limits<float_max_t>::infinity());
+                const float_max_t
+                    first_min = Simd::horizontalMin(Simd::select(mu_min >= Lanes::broadcast(t_min), face_min, infinity)),
+                    first_max = Simd::horizontalMin(Simd::select(mu_max <= Lanes::broadcast(t_max), face_max, infinity));
+
+                result.t_min = t_min, result.face_min = static_cast<unsigned>(first_min);
+                result.t_max = t_max, result.face_max = static_cast<unsigned>(first_max);
+                result.hit = true;
+                return result;
+            }
+
+            PolyhedronHit Polyhedron (
+                const Ray &ray,
+                const ConvexPolyhedron &polyhedron
+            ) {
+                PolyhedronHit result = Polyhedron(ray.getPoint(), ray.getDirection(), polyhedron);
+                result.hit = result.hit && ray.overlaps(result.t_min, result.t_max);
+                return result;
+            }
+
+            TriangleHit Triangle (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &triangle_vertex_0,
+                const Vec<3> &triangle_vertex_1,
+                const Vec<3> &triangle_vertex_2
+            ) {
+                TriangleHit result = {};
+                const float_max_t
+                    *point = line_point.data(),
+                    *direction = line_direction.data(),
+                    *vertex_0 = triangle_vertex_0.data(),
+                    *vertex_1 = triangle_vertex_1.data(),
+                    *vertex_2 = triangle_vertex_2.data();
+
+                float_max_t edge_1[3], edge_2[3], s[3];
+                for (unsigned i = 0; i < 3; ++i) {
+                    edge_1[i] = vertex_1[i] - vertex_0[i];
+                    edge_2[i] = vertex_2[i] - vertex_0[i];
+                    s[i] = point[i] - vertex_0[i];
+                }
+
+                const float_max_t p[3] = {
+                    direction[1] * edge_2[2] - direction[2] * edge_2[1],
+                    direction[2] * edge_2[0] - direction[0] * edge_2[2],
+                    direction[0] * edge_2[1] - direction[1] * edge_2[0]
+                };
+                const float_max_t det = edge_1[0] * p[0] + edge_1[1] * p[1] + edge_1[2] * p[2];
+
+                if (closeToZero(det)) {
+                    return result;
+                }
+
+                const float_max_t inv_det = 1.0 / det;
+                result.u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inv_det;
+                if (result.u < 0.0 || result.u > 1.0) {
+                    return result;
+                }
+
+                const float_max_t q[3] = {
+                    s[1] * edge_1[2] - s[2] * edge_1[1],
+                    s[2] * edge_1[0] - s[0] * edge_1[2],
+                    s[0] * edge_1[1] - s[1] * edge_1[0]
+                };
+                result.v = (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) * inv_det;
+                if (result.v < 0.0 || result.u + result.v > 1.0) {
+                    return result;
+                }
+
+                result.t = (edge_2[0] * q[0] + edge_2[1] * q[1] + edge_2[2] * q[2]) * inv_det;
+                result.hit = true;
+                return result;
+            }
+
+            bool Triangle (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &triangle_vertex_0,
+                const Vec<3> &triangle_vertex_1,
+                const Vec<3> &triangle_vertex_2,
+                float_max_t &t_inter,
+                float_max_t &u,
+                float_max_t &v
+            ) {
+                const TriangleHit result = Triangle(line_point, line_direction, triangle_vertex_0, triangle_vertex_1, triangle_vertex_2);
+                if (result) {
+                    t_inter = result.t, u = result.u, v = result.v;
+                }
+                return result.hit;
+            }
+
+            TriangleHit Triangle (
+                const Ray &ray,
+                const Vec<3> &triangle_vertex_0,
+                const Vec<3> &triangle_vertex_1,
+                const Vec<3> &triangle_vertex_2
+            ) {
+                TriangleHit result = Triangle(ray.getPoint(), ray.getDirection(), triangle_vertex_0, triangle_vertex_1, triangle_vertex_2);
+                result.hit = result.hit && ray.contains(result.t);
+                return result;
+            }
+        };
+
+        namespace Any {
+
+            bool Sphere (
+                const Ray &ray,
+                const Vec<3> &sphere_center,
+                const float_max_t &sphere_radius
+            ) {
+                const Vec<3> diff = ray.getPoint() - sphere_center;
+                const float_max_t
+                    b = diff.dot(ray.getDirection()),
+                    c = diff.length2() - sphere_radius * sphere_radius,
+                    discr = (b * b) - c;
+
+                if (discr < 0.0) {
+                    return false;
+                }
+
+                const float_max_t sqrt_discr = std::sqrt(discr);
+                return ray.contains(-(b + sqrt_discr)) || ray.contains(sqrt_discr - b);
+            }
+
+            bool Box (
+                const Ray &ray,
+                const Vec<3> &box_min,
+                const Vec<3> &box_max
+            ) {
+                const float_max_t
+                    *point = ray.getPoint().data(),
+                    *inv_direction = ray.getInverseDirection().data(),
+                    *bounds[2] = { box_min.data(), box_max.data() };
+                const std::array<unsigned char, 3> &sign = ray.getSign();
+
+                float_max_t
+                    mu_min = -std::numeric_limits<float_max_t>::infinity(),
+                    mu_max = std::numeric_limits<float_max_t>::infinity();
+
+                for (unsigned i = 0; i < 3; ++i) {
+                    Slab<float_max_t>(
+                        (bounds[sign[i]][i] - point[i]) * inv_direction[i],
+                        (bounds[1 - sign[i]][i] - point[i]) * inv_direction[i],
+                        mu_min, mu_max
+                    );
+                }
+
+                return mu_min <= mu_max && (ray.contains(mu_min) || ray.contains(mu_max));
+            }
+
+            bool Cylinder (
+                const Ray &ray,
+                const Vec<3> &cylinder_bottom,
+                const Vec<3> &cylinder_delta,
+                const float_max_t &cylinder_height2,
+                const float_max_t &cylinder_radius
+            ) {
+                const CylinderHit hit = Line::Cylinder(
+                    ray.getPoint(), ray.getDirection(), cylinder_bottom, cylinder_delta, cylinder_height2, cylinder_radius
+                );
+                return hit && (ray.contains(hit.t_min) || ray.contains(hit.t_max));
+            }
+
+            bool Cylinder (
+                const Ray &ray,
+                const Geometry::Cylinder &cylinder
+            ) {
+                const CylinderHit hit = Line::Cylinder(ray.getPoint(), ray.getDirection(), cylinder);
+                return hit && (ray.contains(hit.t_min) || ray.contains(hit.t_max));
+            }
+
+            // The entry only grows and the exit only shrinks, so the clip stops once either leaves the interval
+            bool Polyhedron (
+                const Ray &ray,
+                const std::vector<Geometry::Plane> &planes
+            ) {
+                const Vec<3> &point = ray.getPoint(), &direction = ray.getDirection();
+                float_max_t
+                    mu_min = -std::numeric_limits<float_max_t>::infinity(),
+                    mu_max = std::numeric_limits<float_max_t>::infinity();
+
+                for (const Geometry::Plane &plane : planes) {
+                    const float_max_t
+                        denom = plane.getNormal().dot(direction),
+                        dist = plane.getD() - plane.getNormal().dot(point);
+
+                    if (closeToZero(denom)) {
+                        if (dist < 0.0) {
                             return false;
                         }
+                    } else if (denom < 0.0) {
+                        mu_min = std::max(mu_min, dist / denom);
+                    } else {
+                        mu_max = std::min(mu_max, dist / denom);
+                    }
+
+                    if (mu_min > mu_max || mu_min > ray.getTMax() || mu_max < ray.getTMin()) {
+                        return false;
                     }
                 }
 
-                t_min = mu_min, t_max = mu_max;
+                return ray.contains(mu_min) || ray.contains(mu_max);
+            }
+
+            bool Polyhedron (
+                const Ray &ray,
+                const ConvexPolyhedron &polyhedron
+            ) {
+                const PolyhedronHit hit = Line::Polyhedron(ray.getPoint(), ray.getDirection(), polyhedron);
+                return hit && (ray.contains(hit.t_min) || ray.contains(hit.t_max));
+            }
 
-                return true;
+            bool Triangle (
+                const Ray &ray,
+                const Vec<3> &triangle_vertex_0,
+                const Vec<3> &triangle_vertex_1,
+                const Vec<3> &triangle_vertex_2
+            ) {
+                return Line::Triangle(ray, triangle_vertex_0, triangle_vertex_1, triangle_vertex_2).hit;
             }
         };
     };
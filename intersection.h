@@ -4,40 +4,114 @@
 #include "defaults.h"
 #include "vec.h"
 #include "plane.h"
+#include "convex_polyhedron.h"
+#include "cylinder.h"
+#include "ray.h"
 
 namespace Geometry {
 
     namespace Intersection {
 
-        extern Geometry::Vec<3> __default_vec_3_;
-        extern float_max_t __default_float_max_;
-        extern unsigned __default_unsigned_;
-        extern bool __default_bool_;
+        // Results of the Line queries, returned by value so concurrent queries never share state.
+        // Fields other than hit are only meaningful when hit is true. They convert to bool, so
+        // callers testing the old bool results keep compiling.
+
+        struct PlaneHit {
+            float_max_t t;
+            bool hit;
+
+            inline operator bool (void) const { return this->hit; }
+        };
+
+        struct SphereHit {
+            float_max_t t_min, t_max;
+            bool hit;
+
+            inline operator bool (void) const { return this->hit; }
+        };
+
+        struct BoxHit {
+            float_max_t t_min, t_max;
+            unsigned char axis_t_min, axis_t_max;
+            bool is_t_min_box_min, is_t_max_box_min, hit;
+
+            inline operator bool (void) const { return this->hit; }
+        };
+
+        struct CylinderHit {
+            float_max_t t_min, t_max;
+            bool is_t_min_top_cap, is_t_min_bottom_cap, is_t_max_top_cap, is_t_max_bottom_cap, hit;
+
+            inline operator bool (void) const { return this->hit; }
+        };
+
+        struct PolyhedronHit {
+            float_max_t t_min, t_max;
+            unsigned face_min, face_max;
+            bool hit;
+
+            inline operator bool (void) const { return this->hit; }
+        };
+
+        // The hit point is (1 - u - v) * vertex_0 + u * vertex_1 + v * vertex_2
+        struct TriangleHit {
+            float_max_t t, u, v;
+            bool hit;
+
+            inline operator bool (void) const { return this->hit; }
+        };
 
         namespace Point {
 
+            bool Point (
+                const Vec<3> &point_1,
+                const Vec<3> &point_2
+            );
+
             bool Point (
                 const Vec<3> &point_1,
                 const Vec<3> &point_2,
-                Vec<3> &closest_point = __default_vec_3_
+                Vec<3> &closest_point
+            );
+
+            bool Line (
+                const Vec<3> &point,
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction
+            );
+
+            bool Line (
+                const Vec<3> &point,
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                Vec<3> &closest_point
             );
 
             bool Line (
                 const Vec<3> &point,
                 const Vec<3> &line_point,
                 const Vec<3> &line_direction,
-                Vec<3> &closest_point = __default_vec_3_,
-                float_max_t &t_inter = __default_float_max_
+                Vec<3> &closest_point,
+                float_max_t &t_inter
+            );
+
+            bool Plane (
+                const Vec<3> &point,
+                const Vec<3> &plane_normal,
+                const float_max_t &plane_d
             );
 
             bool Plane (
                 const Vec<3> &point,
                 const Vec<3> &plane_normal,
                 const float_max_t &plane_d,
-                Vec<3> &closest_point = __default_vec_3_
+                Vec<3> &closest_point
             );
         };
 
+        // The bool overloads keep the old call shapes, any trailing outputs may be left out. They write
+        // their outputs on a hit only: on a miss the outputs are left untouched, where older versions
+        // wrote the axes, faces, caps and parameters met before giving up.
         namespace Line {
 
             // NOTE Real-Time Collision Detection
@@ -51,38 +125,197 @@ namespace Geometry {
             );
 
             // NOTE Real-Time Collision Detection : 176
+            PlaneHit Plane (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Geometry::Plane &plane
+            );
+
             bool Plane (
                 const Vec<3> &line_point,
                 const Vec<3> &line_direction,
-                const Plane &plane,
-                float_max_t &t_inter = __default_float_max_
+                const Geometry::Plane &plane,
+                float_max_t &t_inter
+            );
+
+            PlaneHit Plane (
+                const Ray &ray,
+                const Geometry::Plane &plane
             );
 
             // NOTE Real-Time Collision Detection : 178
+            SphereHit Sphere (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &sphere_center,
+                const float_max_t &sphere_radius
+            );
+
+            bool Sphere (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &sphere_center,
+                const float_max_t &sphere_radius,
+                float_max_t &t_min
+            );
+
             bool Sphere (
                 const Vec<3> &line_point,
                 const Vec<3> &line_direction,
                 const Vec<3> &sphere_center,
                 const float_max_t &sphere_radius,
-                float_max_t &t_min = __default_float_max_,
-                float_max_t &t_max = __default_float_max_
+                float_max_t &t_min,
+                float_max_t &t_max
             );
 
             // NOTE Real-Time Collision Detection : 180
+            BoxHit Box (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &box_min,
+                const Vec<3> &box_max
+            );
+
+            bool Box (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &box_min,
+                const Vec<3> &box_max,
+                float_max_t &t_min
+            );
+
+            bool Box (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &box_min,
+                const Vec<3> &box_max,
+                float_max_t &t_min,
+                unsigned &axis_t_min
+            );
+
+            bool Box (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &box_min,
+                const Vec<3> &box_max,
+                float_max_t &t_min,
+                unsigned &axis_t_min,
+                bool &is_t_min_box_min
+            );
+
             bool Box (
                 const Vec<3> &line_point,
                 const Vec<3> &line_direction,
                 const Vec<3> &box_min,
                 const Vec<3> &box_max,
-                float_max_t &t_min = __default_float_max_,
-                unsigned &axis_t_min = __default_unsigned_,
-                bool &is_t_min_box_min = __default_bool_,
-                float_max_t &t_max = __default_float_max_,
-                unsigned &axis_t_max = __default_unsigned_,
-                bool &is_t_max_box_min = __default_bool_
+                float_max_t &t_min,
+                unsigned &axis_t_min,
+                bool &is_t_min_box_min,
+                float_max_t &t_max
+            );
+
+            bool Box (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &box_min,
+                const Vec<3> &box_max,
+                float_max_t &t_min,
+                unsigned &axis_t_min,
+                bool &is_t_min_box_min,
+                float_max_t &t_max,
+                unsigned &axis_t_max
+            );
+
+            bool Box (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &box_min,
+                const Vec<3> &box_max,
+                float_max_t &t_min,
+                unsigned &axis_t_min,
+                bool &is_t_min_box_min,
+                float_max_t &t_max,
+                unsigned &axis_t_max,
+                bool &is_t_max_box_min
+            );
+
+            // Branchless slab test on the cached inverse direction
+            BoxHit Box (
+                const Ray &ray,
+                const Vec<3> &box_min,
+                const Vec<3> &box_max
             );
 
             // NOTE Real-Time Collision Detection : 197
+            CylinderHit Cylinder (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &cylinder_bottom,
+                const Vec<3> &cylinder_delta,
+                const float_max_t &cylinder_height2,
+                const float_max_t &cylinder_radius
+            );
+
+            bool Cylinder (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &cylinder_bottom,
+                const Vec<3> &cylinder_delta,
+                const float_max_t &cylinder_height2,
+                const float_max_t &cylinder_radius,
+                float_max_t &t_min
+            );
+
+            bool Cylinder (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &cylinder_bottom,
+                const Vec<3> &cylinder_delta,
+                const float_max_t &cylinder_height2,
+                const float_max_t &cylinder_radius,
+                float_max_t &t_min,
+                bool &is_t_min_top_cap
+            );
+
+            bool Cylinder (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &cylinder_bottom,
+                const Vec<3> &cylinder_delta,
+                const float_max_t &cylinder_height2,
+                const float_max_t &cylinder_radius,
+                float_max_t &t_min,
+                bool &is_t_min_top_cap,
+                bool &is_t_min_bottom_cap
+            );
+
+            bool Cylinder (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &cylinder_bottom,
+                const Vec<3> &cylinder_delta,
+                const float_max_t &cylinder_height2,
+                const float_max_t &cylinder_radius,
+                float_max_t &t_min,
+                bool &is_t_min_top_cap,
+                bool &is_t_min_bottom_cap,
+                float_max_t &t_max
+            );
+
+            bool Cylinder (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &cylinder_bottom,
+                const Vec<3> &cylinder_delta,
+                const float_max_t &cylinder_height2,
+                const float_max_t &cylinder_radius,
+                float_max_t &t_min,
+                bool &is_t_min_top_cap,
+                bool &is_t_min_bottom_cap,
+                float_max_t &t_max,
+                bool &is_t_max_top_cap
+            );
+
             bool Cylinder (
                 const Vec<3> &line_point,
                 const Vec<3> &line_direction,
@@ -90,23 +323,152 @@ namespace Geometry {
                 const Vec<3> &cylinder_delta,
                 const float_max_t &cylinder_height2,
                 const float_max_t &cylinder_radius,
-                float_max_t &t_min = __default_float_max_,
-                bool &is_t_min_top_cap = __default_bool_,
-                bool &is_t_min_bottom_cap = __default_bool_,
-                float_max_t &t_max = __default_float_max_,
-                bool &is_t_max_top_cap = __default_bool_,
-                bool &is_t_max_bottom_cap = __default_bool_
+                float_max_t &t_min,
+                bool &is_t_min_top_cap,
+                bool &is_t_min_bottom_cap,
+                float_max_t &t_max,
+                bool &is_t_max_top_cap,
+                bool &is_t_max_bottom_cap
+            );
+
+            CylinderHit Cylinder (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Geometry::Cylinder &cylinder
             );
 
             // NOTE Real-Time Collision Detection : 199
+            PolyhedronHit Polyhedron (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const std::vector<Geometry::Plane> &planes
+            );
+
+            bool Polyhedron (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const std::vector<Geometry::Plane> &planes,
+                float_max_t &t_min
+            );
+
             bool Polyhedron (
                 const Vec<3> &line_point,
                 const Vec<3> &line_direction,
                 const std::vector<Geometry::Plane> &planes,
-                float_max_t &t_min = __default_float_max_,
-                unsigned &face_min = __default_unsigned_,
-                float_max_t &t_max = __default_float_max_,
-                unsigned &face_max = __default_unsigned_
+                float_max_t &t_min,
+                unsigned &face_min
+            );
+
+            bool Polyhedron (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const std::vector<Geometry::Plane> &planes,
+                float_max_t &t_min,
+                unsigned &face_min,
+                float_max_t &t_max
+            );
+
+            bool Polyhedron (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const std::vector<Geometry::Plane> &planes,
+                float_max_t &t_min,
+                unsigned &face_min,
+                float_max_t &t_max,
+                unsigned &face_max
+            );
+
+            PolyhedronHit Polyhedron (
+                const Ray &ray,
+                const std::vector<Geometry::Plane> &planes
+            );
+
+            // Same clip over the packed faces, Simd::batchWidth at a time, with the same faces reported
+            PolyhedronHit Polyhedron (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const ConvexPolyhedron &polyhedron
+            );
+
+            PolyhedronHit Polyhedron (
+                const Ray &ray,
+                const ConvexPolyhedron &polyhedron
+            );
+
+            // Both faces are hit, a triangle seen edge on is missed
+            // NOTE Möller, Trumbore, Fast, Minimum Storage Ray/Triangle Intersection
+            TriangleHit Triangle (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &triangle_vertex_0,
+                const Vec<3> &triangle_vertex_1,
+                const Vec<3> &triangle_vertex_2
+            );
+
+            bool Triangle (
+                const Vec<3> &line_point,
+                const Vec<3> &line_direction,
+                const Vec<3> &triangle_vertex_0,
+                const Vec<3> &triangle_vertex_1,
+                const Vec<3> &triangle_vertex_2,
+                float_max_t &t_inter,
+                float_max_t &u,
+                float_max_t &v
+            );
+
+            TriangleHit Triangle (
+                const Ray &ray,
+                const Vec<3> &triangle_vertex_0,
+                const Vec<3> &triangle_vertex_1,
+                const Vec<3> &triangle_vertex_2
+            );
+        };
+
+        // Shadow and visibility queries: true when the surface is crossed inside the ray
+        // interval (the test BVH::intersect applies to t_min and t_max), with no hit record.
+        // They stop as soon as the answer is known.
+        namespace Any {
+
+            bool Sphere (
+                const Ray &ray,
+                const Vec<3> &sphere_center,
+                const float_max_t &sphere_radius
+            );
+
+            bool Box (
+                const Ray &ray,
+                const Vec<3> &box_min,
+                const Vec<3> &box_max
+            );
+
+            bool Cylinder (
+                const Ray &ray,
+                const Vec<3> &cylinder_bottom,
+                const Vec<3> &cylinder_delta,
+                const float_max_t &cylinder_height2,
+                const float_max_t &cylinder_radius
+            );
+
+            bool Cylinder (
+                const Ray &ray,
+                const Geometry::Cylinder &cylinder
+            );
+
+            bool Polyhedron (
+                const Ray &ray,
+                const std::vector<Geometry::Plane> &planes
+            );
+
+            bool Polyhedron (
+                const Ray &ray,
+                const ConvexPolyhedron &polyhedron
+            );
+
+            bool Triangle (
+                const Ray &ray,
+                const Vec<3> &triangle_vertex_0,
+                const Vec<3> &triangle_vertex_1,
+                const Vec<3> &triangle_vertex_2
             );
         };
     };
@@ -0,0 +1,564 @@
+#include <algorithm>
+#include <bitset>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include "intersection_batch.h"
+#include "simd.h"
+#include "slab.h"
+
+namespace Geometry {
+
+    namespace Intersection {
+
+        namespace Batch {
+
+            std::uint64_t Box (
+                const Ray &ray,
+                const std::array<const float_max_t *, 3> &box_min,
+                const std::array<const float_max_t *, 3> &box_max,
+                unsigned count,
+                float_max_t *t_min
+            ) {
+                constexpr unsigned width = Simd::batchWidth<float_max_t>();
+                typedef Simd::Lanes<float_max_t, width> Lanes;
+
+                const std::array<unsigned char, 3> &sign = ray.getSign();
+                const std::array<const float_max_t *, 3> *bounds[2] = { &box_min, &box_max };
+                const float_max_t *ray_point = ray.getPoint().data(), *ray_inv_direction = ray.getInverseDirection().data();
+                const Lanes
+                    ray_t_min = Lanes::broadcast(ray.getTMin()),
+                    ray_t_max = Lanes::broadcast(ray.getTMax());
+
+                Lanes point[3], inv_direction[3];
+                const float_max_t *near[3], *far[3];
+                for (unsigned i = 0; i < 3; ++i) {
+                    point[i] = Lanes::broadcast(ray_point[i]);
+                    inv_direction[i] = Lanes::broadcast(ray_inv_direction[i]);
+                    near[i] = (*bounds[sign[i]])[i];
+                    far[i] = (*bounds[1 - sign[i]])[i];
+                }
+
+                std::uint64_t result = 0;
+
+                for (unsigned first = 0; first < count; first += width) {
+                    Lanes
+                        mu_min = Lanes::broadcast(-std::numeric_limits<float_max_t>::infinity()),
+                        mu_max = Lanes::broadcast(std::numeric_limits<float_max_t>::infinity());
+
+                    for (unsigned i = 0; i < 3; ++i) {
+                        Slab(
+                            (Lanes::load(near[i] + first) - point[i]) * inv_direction[i],
+                            (Lanes::load(far[i] + first) - point[i]) * inv_direction[i],
+                            mu_min, mu_max
+                        );
+                    }
+
+                    mu_min.store(t_min + first);
+                    result |= static_cast<std::uint64_t>(((mu_min <= mu_max) & (mu_min <= ray_t_max) & (ray_t_min <= mu_max)).bits()) << first;
+                }
+
+                return count < 64 ? result & ((std::uint64_t(1) << count) - 1) : result;
+            }
+
+            BoxBatchHit Box (
+                const Ray &ray,
+                const VecArray<3> &box_min,
+                const VecArray<3> &box_max
+            ) {
+                const std::size_t size = box_min.size();
+                if (box_max.size() != size) {
+                    throw std::invalid_argument(std::to_string(box_max.size()) + " box_max given to " + std::to_string(size) + " box_min");
+                }
+
+                BoxBatchHit result;
+                result.mask.resize((size + 63) / 64);
+                result.t_min.resize(size);
+                result.count = 0;
+
+                // The arrays aren't padded, so the boxes after the last whole group are copied out
+                constexpr unsigned width = Simd::batchWidth<float_max_t>();
+                const std::size_t whole = size - size % width;
+                alignas(32) float_max_t tail[2][3][width], tail_t_min[width];
+
+                for (std::size_t first = 0, block = 0; first < size; first += 64, ++block) {
+                    const unsigned count = static_cast<unsigned>(std::min<std::size_t>(64, size - first));
+                    const unsigned padded = static_cast<unsigned>(std::min<std::size_t>(count, whole - first));
+
+                    std::uint64_t mask = padded == 0 ? 0 : Box(
+                        ray,
+                        { box_min.lane(0) + first, box_min.lane(1) + first, box_min.lane(2) + first },
+                        { box_max.lane(0) + first, box_max.lane(1) + first, box_max.lane(2) + first },
+                        padded,
+                        result.t_min.data() + first
+                    );
+
+                    if (padded < count) {
+                        const unsigned remaining = count - padded;
+                        for (unsigned i = 0; i < 3; ++i) {
+                            for (unsigned lane = 0; lane < width; ++lane) {
+                                const std::size_t box = first + padded + std::min(lane, remaining - 1);
+                                tail[0][i][lane] = box_min.lane(i)[box];
+                                tail[1][i][lane] = box_max.lane(i)[box];
+                            }
+                        }
+                        mask |= Box(ray, { tail[0][0], tail[0][1], tail[0][2] }, { tail[1][0], tail[1][1], tail[1][2] }, remaining, tail_t_min) << padded;
+                        std::copy(tail_t_min, tail_t_min + remaining, result.t_min.data() + first + padded);
+                    }
+
+                    result.mask[block] = mask;
+                    result.count += std::bitset<64>(mask).count();
+                }
+
+                return result;
+            }
+
+            std::uint64_t Triangle (
+                const Ray &ray,
+                const std::array<const float_max_t *, 3> &triangle_vertex_0,
+                const std::array<const float_max_t *, 3> &triangle_edge_1,
+                const std::array<const float_max_t *, 3> &triangle_edge_2,
+                unsigned count,
+                float_max_t *t,
+                float_max_t *u,
+                float_max_t *v
+            ) {
+                constexpr unsigned width = Simd::batchWidth<float_max_t>();
+                typedef Simd::Lanes<float_max_t, width> Lanes;
+
+                const float_max_t *ray_point = ray.getPoint().data(), *ray_direction = ray.getDirection().data();
+                const Lanes
+                    zero = Lanes::broadcast(0.0),
+                    one = Lanes::broadcast(1.0),
+                    epsilon = Lanes::broadcast(EPSILON),
+                    ray_t_min = Lanes::broadcast(ray.getTMin()),
+                    ray_t_max = Lanes::broadcast(ray.getTMax());
+
+                Lanes point[3], direction[3];
+                for (unsigned i = 0; i < 3; ++i) {
+                    point[i] = Lanes::broadcast(ray_point[i]);
+                    direction[i] = Lanes::broadcast(ray_direction[i]);
+                }
+
+                std::uint64_t result = 0;
+
+                for (unsigned first = 0; first < count; first += width) {
+                    Lanes edge_1[3], edge_2[3], s[3];
+                    for (unsigned i = 0; i < 3; ++i) {
+                        edge_1[i] = Lanes::load(triangle_edge_1[i] + first);
+                        edge_2[i] = Lanes::load(triangle_edge_2[i] + first);
+                        s[i] = point[i] - Lanes::load(triangle_vertex_0[i] + first);
+                    }
+
+                    const Lanes
+                        p_x = direction[1] * edge_2[2] - direction[2] * edge_2[1],
+                        p_y = direction[2] * edge_2[0] - direction[0] * edge_2[2],
+                        p_z = direction[0] * edge_2[1] - direction[1] * edge_2[0],
+                        q_x = s[1] * edge_1[2] - s[2] * edge_1[1],
+                        q_y = s[2] * edge_1[0] - s[0] * edge_1[2],
+                        q_z = s[0] * edge_1[1] - s[1] * edge_1[0],
+                        det = edge_1[0] * p_x + edge_1[1] * p_y + edge_1[2] * p_z,
+                        inv_det = one / det,
+                        mu_u = (s[0] * p_x + s[1] * p_y + s[2] * p_z) * inv_det,
+                        mu_v = (direction[0] * q_x + direction[1] * q_y + direction[2] * q_z) * inv_det,
+                        mu_t = (edge_2[0] * q_x + edge_2[1] * q_y + edge_2[2] * q_z) * inv_det,
+                        hit =
+                            ((det > epsilon) | (det < zero - epsilon)) &
+                            (mu_u >= zero) & (mu_v >= zero) & (mu_u + mu_v <= one) &
+                            (ray_t_min <= mu_t) & (mu_t <= ray_t_max);
+
+                    mu_t.store(t + first);
+                    mu_u.store(u + first);
+                    mu_v.store(v + first);
+                    result |= static_cast<std::uint64_t>(hit.bits()) << first;
+                }
+
+                return count < 64 ? result & ((std::uint64_t(1) << count) - 1) : result;
+            }
+
+            std::uint64_t Plane (
+                const std::array<const float_max_t *, 3> &line_point,
+                const std::array<const float_max_t *, 3> &line_direction,
+                unsigned count,
+                const Geometry::Plane &plane,
+                float_max_t *t,
+                float_max_t *s_param,
+                float_max_t *t_param
+            ) {
+                constexpr unsigned width = Simd::batchWidth<float_max_t>();
+                typedef Simd::Lanes<float_max_t, width> Lanes;
+
+                const float_max_t *plane_normal = plane.getNormal().data();
+                const unsigned s_index = plane.getSIndex(), t_index = plane.getTIndex();
+                const bool params = s_param != nullptr && t_param != nullptr;
+                const Lanes
+                    epsilon = Lanes::broadcast(EPSILON),
+                    minus_epsilon = Lanes::broadcast(-EPSILON),
+                    d = Lanes::broadcast(plane.getD());
+
+                Lanes normal[3];
+                for (unsigned i = 0; i < 3; ++i) {
+                    normal[i] = Lanes::broadcast(plane_normal[i]);
+                }
+
+                std::uint64_t result = 0;
+
+                for (unsigned first = 0; first < count; first += width) {
+                    Lanes point[3], direction[3];
+                    for (unsigned i = 0; i < 3; ++i) {
+                        point[i] = Lanes::load(line_point[i] + first);
+                        direction[i] = Lanes::load(line_direction[i] + first);
+                    }
+
+                    const Lanes
+                        dot = normal[0] * direction[0] + normal[1] * direction[1] + normal[2] * direction[2],
+                        distance = d - (normal[0] * point[0] + normal[1] * point[1] + normal[2] * point[2]),
+                        mu = distance / dot;
+
+                    mu.store(t + first);
+                    if (params) {
+                        (point[s_index] + direction[s_index] * mu).store(s_param + first);
+                        (point[t_index] + direction[t_index] * mu).store(t_param + first);
+                    }
+                    result |= static_cast<std::uint64_t>(((dot > epsilon) | (dot < minus_epsilon)).bits()) << first;
+                }
+
+                return count < 64 ? result & ((std::uint64_t(1) << count) - 1) : result;
+            }
+
+            PlaneBatchHit Plane (
+                const VecArray<3> &line_point,
+                const VecArray<3> &line_direction,
+                const Geometry::Plane &plane,
+                bool params
+            ) {
+                const std::size_t size = line_point.size();
+                if (line_direction.size() != size) {
+                    throw std::invalid_argument(std::to_string(line_direction.size()) + " line_direction given to " + std::to_string(size) + " line_point");
+                }
+
+                PlaneBatchHit result;
+                result.mask.resize((size + 63) / 64);
+                result.t.resize(size);
+                if (params) {
+                    result.s_param.resize(size), result.t_param.resize(size);
+                }
+                result.count = 0;
+
+                // The arrays aren't padded, so the lines after the last whole group are copied out
+                constexpr unsigned width = Simd::batchWidth<float_max_t>();
+                const std::size_t whole = size - size % width;
+                alignas(32) float_max_t tail[2][3][width], tail_t[width], tail_s_param[width], tail_t_param[width];
+
+                for (std::size_t first = 0, block = 0; first < size; first += 64, ++block) {
+                    const unsigned count = static_cast<unsigned>(std::min<std::size_t>(64, size - first));
+                    const unsigned padded = static_cast<unsigned>(std::min<std::size_t>(count, whole - first));
+
+                    std::uint64_t mask = padded == 0 ? 0 : Plane(
+                        { line_point.lane(0) + first, line_point.lane(1) + first, line_point.lane(2) + first },
+                        { line_direction.lane(0) + first, line_direction.lane(1) + first, line_direction.lane(2) + first },
+                        padded, plane,
+                        result.t.data() + first,
+                        params ? result.s_param.data() + first : nullptr,
+                        params ? result.t_param.data() + first : nullptr
+                    );
+
+                    if (padded < count) {
+                        const unsigned remaining = count - padded;
+                        for (unsigned i = 0; i < 3; ++i) {
+                            for (unsigned lane = 0; lane < width; ++lane) {
+                                const std::size_t line = first + padded + std::min(lane, remaining - 1);
+                                tail[0][i][lane] = line_point.lane(i)[line];
+                                tail[1][i][lane] = line_direction.lane(i)[line];
+                            }
+                        }
+                        mask |= Plane(
+                            { tail[0][0], tail[0][1], tail[0][2] }, { tail[1][0], tail[1][1], tail[1][2] }, remaining, plane,
+                            tail_t, params ? tail_s_param : nullptr, params ? tail_t_param : nullptr
+                        ) << padded;
+                        std::copy(tail_t, tail_t + remaining, result.t.data() + first + padded);
+                        if (params) {
+                            std::copy(tail_s_param, tail_s_param + remaining, result.s_param.data() + first + padded);
+                            std::copy(tail_t_param, tail_t_param + remaining, result.t_param.data() + first + padded);
+                        }
+                    }
+
+                    result.mask[block] = mask;
+                    result.count += std::bitset<64>(mask).count();
+                }
+
+                return result;
+            }
+
+            SphereBatchHit Sphere (
+                const Ray &ray,
+                const std::array<const float_max_t *, 3> &sphere_center,
+                const float_max_t *sphere_radius,
+                std::size_t count
+            ) {
+                constexpr unsigned width = Simd::batchWidth<float_max_t>();
+                typedef Simd::Lanes<float_max_t, width> Lanes;
+
+                const float_max_t *ray_point = ray.getPoint().data(), *ray_direction = ray.getDirection().data();
+                const Lanes
+                    zero = Lanes::broadcast(0.0),
+                    ray_t_min = Lanes::broadcast(ray.getTMin());
+
+                Lanes point[3], direction[3];
+                for (unsigned i = 0; i < 3; ++i) {
+                    point[i] = Lanes::broadcast(ray_point[i]);
+                    direction[i] = Lanes::broadcast(ray_direction[i]);
+                }
+
+                SphereBatchHit result = { ray.getTMax(), 0, false };
+                Lanes ray_t_max = Lanes::broadcast(result.t);
+                alignas(32) float_max_t t[width];
+
+                for (std::size_t first = 0; first < count; first += width) {
+                    Lanes b = zero, c = zero;
+                    for (unsigned i = 0; i < 3; ++i) {
+                        const Lanes diff = point[i] - Lanes::load(sphere_center[i] + first);
+                        b = b + diff * direction[i];
+                        c = c + diff * diff;
+                    }
+                    const Lanes radius = Lanes::load(sphere_radius + first), discr = b * b - (c - radius * radius), reached = discr >= zero;
+
+                    if (reached.bits() == 0) {
+                        continue;
+                    }
+
+                    const Lanes
+                        sqrt_discr = sqrt(max(discr, zero)),
+                        mu_1 = zero - (b + sqrt_discr),
+                        mu_2 = sqrt_discr - b,
+                        mu = Simd::select(mu_1 >= ray_t_min, mu_1, mu_2);
+
+                    unsigned mask = (reached & (ray_t_min <= mu) & (mu <= ray_t_max)).bits();
+                    if (mask == 0) {
+                        continue;
+                    }
+
+                    const unsigned lanes = static_cast<unsigned>(std::min<std::size_t>(width, count - first));
+                    mask &= (1u << lanes) - 1;
+                    mu.store(t);
+                    for (unsigned lane = 0; mask != 0; ++lane, mask >>= 1) {
+                        if ((mask & 1u) && (!result.hit || t[lane] < result.t)) {
+                            result = { t[lane], first + lane, true };
+                        }
+                    }
+                    ray_t_max = Lanes::broadcast(result.t);
+                }
+
+                return result;
+            }
+
+            SphereBatchHit Sphere (
+                const Ray &ray,
+                const VecArray<3> &sphere_center,
+                const std::vector<float_max_t> &sphere_radius
+            ) {
+                const std::size_t size = sphere_center.size();
+                if (sphere_radius.size() != size) {
+                    throw std::invalid_argument(std::to_string(sphere_radius.size()) + " sphere_radius given to " + std::to_string(size) + " sphere_center");
+                }
+
+                // The arrays aren't padded, so the spheres after the last whole group are copied out
+                constexpr unsigned width = Simd::batchWidth<float_max_t>();
+                const std::size_t whole = size - size % width;
+
+                SphereBatchHit result = Sphere(
+                    ray,
+                    { sphere_center.lane(0), sphere_center.lane(1), sphere_center.lane(2) },
+                    sphere_radius.data(),
+                    whole
+                );
+
+                if (whole < size) {
+                    alignas(32) float_max_t tail[3][width], tail_radius[width];
+                    for (unsigned lane = 0; lane < width; ++lane) {
+                        const std::size_t sphere = std::min<std::size_t>(whole + lane, size - 1);
+                        for (unsigned i = 0; i < 3; ++i) {
+                            tail[i][lane] = sphere_center.lane(i)[sphere];
+                        }
+                        tail_radius[lane] = sphere_radius[sphere];
+                    }
+
+                    Ray probe = ray;
+                    probe.setInterval(ray.getTMin(), result.t);
+                    const SphereBatchHit tail_result = Sphere(probe, { tail[0], tail[1], tail[2] }, tail_radius, size - whole);
+                    if (tail_result && (!result.hit || tail_result.t < result.t)) {
+                        result = { tail_result.t, whole + tail_result.sphere, true };
+                    }
+                }
+
+                return result;
+            }
+        };
+
+        namespace Cull {
+
+            // Every face is tested on every group, stopping once all lanes are out mispredicts more than it saves
+            std::uint64_t Box (
+                const ConvexPolyhedron &polyhedron,
+                const std::array<const float_max_t *, 3> &box_min,
+                const std::array<const float_max_t *, 3> &box_max,
+                unsigned count
+            ) {
+                constexpr unsigned width = Simd::batchWidth<float_max_t>();
+                constexpr unsigned group = (1u << width) - 1;
+                typedef Simd::Lanes<float_max_t, width> Lanes;
+
+                const unsigned faces = polyhedron.size();
+                const float_max_t *normals[3] = { polyhedron.getNormals(0), polyhedron.getNormals(1), polyhedron.getNormals(2) }, *d = polyhedron.getDs();
+                const Lanes zero = Lanes::broadcast(0.0);
+
+                std::uint64_t result = 0;
+
+                for (unsigned first = 0; first < count; first += width) {
+                    Lanes outside = zero > zero;
+                    for (unsigned face = 0; face < faces; ++face) {
+                        Lanes distance = Lanes::broadcast(-d[face]);
+                        for (unsigned i = 0; i < 3; ++i) {
+                            const float_max_t normal = normals[i][face];
+                            distance = distance + Lanes::broadcast(normal) * Lanes::load((normal >= 0.0 ? box_min : box_max)[i] + first);
+                        }
+                        outside = outside | (distance > zero);
+                    }
+                    result |= static_cast<std::uint64_t>(~outside.bits() & group) << first;
+                }
+
+                return count < 64 ? result & ((std::uint64_t(1) << count) - 1) : result;
+            }
+
+            std::vector<std::uint64_t> Box (
+                const ConvexPolyhedron &polyhedron,
+                const VecArray<3> &box_min,
+                const VecArray<3> &box_max
+            ) {
+                const std::size_t size = box_min.size();
+                if (box_max.size() != size) {
+                    throw std::invalid_argument(std::to_string(box_max.size()) + " box_max given to " + std::to_string(size) + " box_min");
+                }
+
+                std::vector<std::uint64_t> result((size + 63) / 64);
+
+                // The arrays aren't padded, so the boxes after the last whole group are copied out
+                constexpr unsigned width = Simd::batchWidth<float_max_t>();
+                const std::size_t whole = size - size % width;
+                alignas(32) float_max_t tail[2][3][width];
+
+                for (std::size_t first = 0, block = 0; first < size; first += 64, ++block) {
+                    const unsigned count = static_cast<unsigned>(std::min<std::size_t>(64, size - first));
+                    const unsigned padded = static_cast<unsigned>(std::min<std::size_t>(count, whole - first));
+
+                    std::uint64_t mask = padded == 0 ? 0 : Box(
+                        polyhedron,
+                        { box_min.lane(0) + first, box_min.lane(1) + first, box_min.lane(2) + first },
+                        { box_max.lane(0) + first, box_max.lane(1) + first, box_max.lane(2) + first },
+                        padded
+                    );
+
+                    if (padded < count) {
+                        const unsigned remaining = count - padded;
+                        for (unsigned i = 0; i < 3; ++i) {
+                            for (unsigned lane = 0; lane < width; ++lane) {
+                                const std::size_t box = first + padded + std::min(lane, remaining - 1);
+                                tail[0][i][lane] = box_min.lane(i)[box];
+                                tail[1][i][lane] = box_max.lane(i)[box];
+                            }
+                        }
+                        mask |= Box(polyhedron, { tail[0][0], tail[0][1], tail[0][2] }, { tail[1][0], tail[1][1], tail[1][2] }, remaining) << padded;
+                    }
+
+                    result[block] = mask;
+                }
+
+                return result;
+            }
+
+            std::uint64_t Sphere (
+                const ConvexPolyhedron &polyhedron,
+                const std::array<const float_max_t *, 3> &sphere_center,
+                const float_max_t *sphere_radius,
+                unsigned count
+            ) {
+                constexpr unsigned width = Simd::batchWidth<float_max_t>();
+                constexpr unsigned group = (1u << width) - 1;
+                typedef Simd::Lanes<float_max_t, width> Lanes;
+
+                const unsigned faces = polyhedron.size();
+                const float_max_t *normals[3] = { polyhedron.getNormals(0), polyhedron.getNormals(1), polyhedron.getNormals(2) }, *d = polyhedron.getDs();
+                const Lanes zero = Lanes::broadcast(0.0);
+
+                std::uint64_t result = 0;
+
+                for (unsigned first = 0; first < count; first += width) {
+                    Lanes center[3];
+                    for (unsigned i = 0; i < 3; ++i) {
+                        center[i] = Lanes::load(sphere_center[i] + first);
+                    }
+                    const Lanes radius = Lanes::load(sphere_radius + first);
+
+                    Lanes outside = zero > zero;
+                    for (unsigned face = 0; face < faces; ++face) {
+                        const Lanes distance =
+                            Lanes::broadcast(normals[0][face]) * center[0] +
+                            Lanes::broadcast(normals[1][face]) * center[1] +
+                            Lanes::broadcast(normals[2][face]) * center[2] -
+                            Lanes::broadcast(d[face]);
+                        outside = outside | (distance > radius);
+                    }
+                    result |= static_cast<std::uint64_t>(~outside.bits() & group) << first;
+                }
+
+                return count < 64 ? result & ((std::uint64_t(1) << count) - 1) : result;
+            }
+
+            std::vector<std::uint64_t> Sphere (
+                const ConvexPolyhedron &polyhedron,
+                const VecArray<3> &sphere_center,
+                const std::vector<float_max_t> &sphere_radius
+            ) {
+                const std::size_t size = sphere_center.size();
+                if (sphere_radius.size() != size) {
+                    throw std::invalid_argument(std::to_string(sphere_radius.size()) + " sphere_radius given to " + std::to_string(size) + " sphere_center");
+                }
+
+                std::vector<std::uint64_t> result((size + 63) / 64);
+
+                // The arrays aren't padded, so the spheres after the last whole group are copied out
+                constexpr unsigned width = Simd::batchWidth<float_max_t>();
+                const std::size_t whole = size - size % width;
+                alignas(32) float_max_t tail[3][width], tail_radius[width];
+
+                for (std::size_t first = 0, block = 0; first < size; first += 64, ++block) {
+                    const unsigned count = static_cast<unsigned>(std::min<std::size_t>(64, size - first));
+                    const unsigned padded = static_cast<unsigned>(std::min<std::size_t>(count, whole - first));
+
+                    std::uint64_t mask = padded == 0 ? 0 : Sphere(
+                        polyhedron,
+                        { sphere_center.lane(0) + first, sphere_center.lane(1) + first, sphere_center.lane(2) + first },
+                        sphere_radius.data() + first,
+                        padded
+                    );
+
+                    if (padded < count) {
+                        const unsigned remaining = count - padded;
+                        for (unsigned lane = 0; lane < width; ++lane) {
+                            const std::size_t sphere = first + padded + std::min(lane, remaining - 1);
+                            for (unsigned i = 0; i < 3; ++i) {
+                                tail[i][lane] = sphere_center.lane(i)[sphere];
+                            }
+                            tail_radius[lane] = sphere_radius[sphere];
+                        }
+                        mask |= Sphere(polyhedron, { tail[0], tail[1], tail[2] }, tail_radius, remaining) << padded;
+                    }
+
+                    result[block] = mask;
+                }
+
+                return result;
+            }
+        };
+    };
+};
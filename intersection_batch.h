@@ -0,0 +1,158 @@
+#ifndef MODULE_GRAPHICS_GEOMETRY_INTERSECTION_BATCH_H_
+#define MODULE_GRAPHICS_GEOMETRY_INTERSECTION_BATCH_H_
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include "defaults.h"
+#include "vec.h"
+#include "vec_array.h"
+#include "plane.h"
+#include "convex_polyhedron.h"
+#include "ray.h"
+
+namespace Geometry {
+
+    namespace Intersection {
+
+        // One ray against many boxes, box i hit when bit i % 64 of mask[i / 64] is set.
+        // t_min holds the entry distance of every box, only meaningful for the hits.
+        struct BoxBatchHit {
+            std::vector<std::uint64_t> mask;
+            std::vector<float_max_t> t_min;
+            std::size_t count;
+
+            inline bool hit (std::size_t box) const { return (this->mask[box / 64] >> (box % 64)) & 1u; }
+            inline explicit operator bool (void) const { return this->count != 0; }
+        };
+
+        // Many lines against one plane, line i hit when bit i % 64 of mask[i / 64] is set. t holds the
+        // distance along every line and s_param and t_param the plane parameters of the hit point,
+        // as Plane::param gives them, only when they were asked for. All only meaningful for the hits.
+        struct PlaneBatchHit {
+            std::vector<std::uint64_t> mask;
+            std::vector<float_max_t> t, s_param, t_param;
+            std::size_t count;
+
+            inline bool hit (std::size_t line) const { return (this->mask[line / 64] >> (line % 64)) & 1u; }
+            inline explicit operator bool (void) const { return this->count != 0; }
+        };
+
+        // Nearest of many spheres, at the distance Any::Sphere would find inside the ray interval:
+        // the entry if it's inside, the exit otherwise. Ties go to the lowest index.
+        struct SphereBatchHit {
+            float_max_t t;
+            std::size_t sphere;
+            bool hit;
+
+            inline explicit operator bool (void) const { return this->hit; }
+        };
+
+        namespace Batch {
+
+            // Leaf routine: the slab test of Line::Box (const Ray &, ...) over up to 64 boxes given
+            // lane by lane, Simd::batchWidth boxes at a time. Whole groups are always read and
+            // written, so the bounds and t_min must stay valid up to count rounded up to batchWidth;
+            // boxes past count are left out of the mask.
+            std::uint64_t Box (
+                const Ray &ray,
+                const std::array<const float_max_t *, 3> &box_min,
+                const std::array<const float_max_t *, 3> &box_max,
+                unsigned count,
+                float_max_t *t_min
+            );
+
+            BoxBatchHit Box (
+                const Ray &ray,
+                const VecArray<3> &box_min,
+                const VecArray<3> &box_max
+            );
+
+            // Same leaf contract as Box, with Line::Triangle (const Ray &, ...) over triangles given
+            // as their first vertex and the two edges leaving it. Degenerate padding triangles
+            // (zero edges) are always missed. Hit distances and barycentrics go to t, u and v.
+            std::uint64_t Triangle (
+                const Ray &ray,
+                const std::array<const float_max_t *, 3> &triangle_vertex_0,
+                const std::array<const float_max_t *, 3> &triangle_edge_1,
+                const std::array<const float_max_t *, 3> &triangle_edge_2,
+                unsigned count,
+                float_max_t *t,
+                float_max_t *u,
+                float_max_t *v
+            );
+
+            // Leaf routine: Line::Plane over up to 64 lines given lane by lane, Simd::batchWidth lines
+            // at a time, with the same whole group contract as Box on the lines and the outputs. The
+            // directions aren't normalized, t is in their length. s_param and t_param may be null.
+            std::uint64_t Plane (
+                const std::array<const float_max_t *, 3> &line_point,
+                const std::array<const float_max_t *, 3> &line_direction,
+                unsigned count,
+                const Geometry::Plane &plane,
+                float_max_t *t,
+                float_max_t *s_param = nullptr,
+                float_max_t *t_param = nullptr
+            );
+
+            PlaneBatchHit Plane (
+                const VecArray<3> &line_point,
+                const VecArray<3> &line_direction,
+                const Geometry::Plane &plane,
+                bool params = false
+            );
+
+            // The quadratic of Line::Sphere over any count of spheres given lane by lane, read in whole
+            // groups as in Box. Groups where no lane reaches the discriminant skip the square root,
+            // and the ray interval shrinks to every closer hit, so far spheres mostly stop there too.
+            SphereBatchHit Sphere (
+                const Ray &ray,
+                const std::array<const float_max_t *, 3> &sphere_center,
+                const float_max_t *sphere_radius,
+                std::size_t count
+            );
+
+            SphereBatchHit Sphere (
+                const Ray &ray,
+                const VecArray<3> &sphere_center,
+                const std::vector<float_max_t> &sphere_radius
+            );
+        };
+
+        // Culling against a convex volume, such as Camera::getFrustum, with the same whole group
+        // contract as Batch. A bit is set when the primitive may be inside: it's only cleared when
+        // the primitive lies wholly outside one face, so a few primitives past the corners stay set.
+        namespace Cull {
+
+            // Leaf routine over up to 64 boxes, each face tested with the corner furthest inside it
+            std::uint64_t Box (
+                const ConvexPolyhedron &polyhedron,
+                const std::array<const float_max_t *, 3> &box_min,
+                const std::array<const float_max_t *, 3> &box_max,
+                unsigned count
+            );
+
+            // Box i kept when bit i % 64 of the result [i / 64] is set
+            std::vector<std::uint64_t> Box (
+                const ConvexPolyhedron &polyhedron,
+                const VecArray<3> &box_min,
+                const VecArray<3> &box_max
+            );
+
+            std::uint64_t Sphere (
+                const ConvexPolyhedron &polyhedron,
+                const std::array<const float_max_t *, 3> &sphere_center,
+                const float_max_t *sphere_radius,
+                unsigned count
+            );
+
+            std::vector<std::uint64_t> Sphere (
+                const ConvexPolyhedron &polyhedron,
+                const VecArray<3> &sphere_center,
+                const std::vector<float_max_t> &sphere_radius
+            );
+        };
+    };
+};
+
+#endif
@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include "mesh.h"
+#include "intersection_batch.h"
+#include "simd.h"
+
+namespace Geometry {
+
+    Mesh::Mesh (
+        const std::vector<Vec<3>> &_vertices,
+        const std::vector<unsigned> &_indices
+    ) : vertices(_vertices) {
+        if (_indices.size() % 3 != 0) {
+            throw std::invalid_argument(std::to_string(_indices.size()) + " indices given to a triangle mesh");
+        }
+        const unsigned count = this->vertices.size();
+        for (unsigned index : _indices) {
+            if (index >= count) {
+                throw std::invalid_argument("vertex " + std::to_string(index) + " given to a mesh of " + std::to_string(count) + " vertices");
+            }
+        }
+        this->indices = _indices;
+        this->updateAll();
+    }
+
+    unsigned Mesh::addVertex (const Vec<3> &vertex) {
+        this->vertices.push_back(vertex);
+        return this->vertices.size() - 1;
+    }
+
+    unsigned Mesh::addTriangle (unsigned index_0, unsigned index_1, unsigned index_2) {
+        const unsigned count = this->vertices.size();
+        if (index_0 >= count || index_1 >= count || index_2 >= count) {
+            throw std::invalid_argument(
+                "vertices " + std::to_string(index_0) + ", " + std::to_string(index_1) + ", " + std::to_string(index_2) +
+                " given to a mesh of " + std::to_string(count) + " vertices"
+            );
+        }
+        this->indices.push_back(index_0);
+        this->indices.push_back(index_1);
+        this->indices.push_back(index_2);
+
+        const unsigned triangle = this->getTriangleCount() - 1, padded = triangle + Simd::batchWidth<float_max_t>();
+        this->vertex_0.resize(padded), this->edge_1.resize(padded), this->edge_2.resize(padded);
+        this->update(triangle);
+        return triangle;
+    }
+
+    void Mesh::setVertex (unsigned vertex, const Vec<3> &position) {
+        if (vertex >= this->vertices.size()) {
+            throw std::invalid_argument("vertex " + std::to_string(vertex) + " doesn't exist");
+        }
+        this->vertices.set(vertex, position);
+        const unsigned size = this->indices.size();
+        for (unsigned i = 0; i < size; i += 3) {
+            if (this->indices[i] == vertex || this->indices[i + 1] == vertex || this->indices[i + 2] == vertex) {
+                this->update(i / 3);
+            }
+        }
+    }
+
+    void Mesh::transform (const std::array<float_max_t, 16> &matrix, const Vec<3> &pivot) {
+        this->vertices.transform(matrix, pivot);
+        this->updateAll();
+    }
+
+    void Mesh::clear (void) {
+        this->vertices.clear(), this->indices.clear();
+        this->vertex_0.clear(), this->edge_1.clear(), this->edge_2.clear();
+    }
+
+// -------------------------------------
+
+    void Mesh::update (unsigned triangle) {
+        const Vec<3> vertex = this->getVertex(triangle, 0);
+        this->vertex_0.set(triangle, vertex);
+        this->edge_1.set(triangle, this->getVertex(triangle, 1) - vertex);
+        this->edge_2.set(triangle, this->getVertex(triangle, 2) - vertex);
+    }
+
+    void Mesh::updateAll (void) {
+        const unsigned count = this->getTriangleCount(), padded = count + Simd::batchWidth<float_max_t>() - 1;
+        this->vertex_0.clear(), this->edge_1.clear(), this->edge_2.clear();
+        this->vertex_0.resize(padded), this->edge_1.resize(padded), this->edge_2.resize(padded);
+        for (unsigned triangle = 0; triangle < count; ++triangle) {
+            this->update(triangle);
+        }
+    }
+
+// -----------------------------------------------------------------------------
+
+    Vec<3> Mesh::getNormal (unsigned triangle) const {
+        return this->edge_1.get(triangle).cross(this->edge_2.get(triangle)).normalized();
+    }
+
+    Vec<3> Mesh::getPoint (unsigned triangle, float_max_t u, float_max_t v) const {
+        return this->vertex_0.get(triangle) + this->edge_1.get(triangle) * u + this->edge_2.get(triangle) * v;
+    }
+
+    AABB Mesh::getBounds (unsigned triangle) const {
+        return Bounds::Triangle(this->getVertex(triangle, 0), this->getVertex(triangle, 1), this->getVertex(triangle, 2));
+    }
+
+    // Vertices no triangle uses are left out
+    AABB Mesh::getBounds (void) const {
+        AABB result;
+        for (unsigned index : this->indices) {
+            result.extend(this->vertices.get(index));
+        }
+        return result;
+    }
+
+    Intersection::TriangleHit Mesh::intersect (unsigned triangle, const Ray &ray) const {
+        return Intersection::Line::Triangle(ray, this->getVertex(triangle, 0), this->getVertex(triangle, 1), this->getVertex(triangle, 2));
+    }
+
+// -------------------------------------
+
+    // 64 triangles per Batch::Triangle call, the interval shrinking to the closest hit between calls
+    Mesh::Hit Mesh::closest (const Ray &ray) const {
+        alignas(32) float_max_t t[64], u[64], v[64];
+        const unsigned count = this->getTriangleCount();
+
+        Hit result = {};
+        Ray probe = ray;
+
+        for (unsigned first = 0; first < count; first += 64) {
+            std::uint64_t mask = Intersection::Batch::Triangle(
+                probe,
+                { this->vertex_0.lane(0) + first, this->vertex_0.lane(1) + first, this->vertex_0.lane(2) + first },
+                { this->edge_1.lane(0) + first, this->edge_1.lane(1) + first, this->edge_1.lane(2) + first },
+                { this->edge_2.lane(0) + first, this->edge_2.lane(1) + first, this->edge_2.lane(2) + first },
+                std::min(64u, count - first),
+                t, u, v
+            );
+            if (mask == 0) {
+                continue;
+            }
+            for (unsigned lane = 0; mask != 0; ++lane, mask >>= 1) {
+                if ((mask & 1u) && (!result.hit || t[lane] < result.t)) {
+                    result = { t[lane], u[lane], v[lane], first + lane, true };
+                }
+            }
+            probe.setInterval(ray.getTMin(), result.t);
+        }
+
+        return result;
+    }
+
+    bool Mesh::any (const Ray &ray) const {
+        alignas(32) float_max_t t[64], u[64], v[64];
+        const unsigned count = this->getTriangleCount();
+
+        for (unsigned first = 0; first < count; first += 64) {
+            if (Intersection::Batch::Triangle(
+                ray,
+                { this->vertex_0.lane(0) + first, this->vertex_0.lane(1) + first, this->vertex_0.lane(2) + first },
+                { this->edge_1.lane(0) + first, this->edge_1.lane(1) + first, this->edge_1.lane(2) + first },
+                { this->edge_2.lane(0) + first, this->edge_2.lane(1) + first, this->edge_2.lane(2) + first },
+                std::min(64u, count - first),
+                t, u, v
+            ) != 0) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+};
@@ -0,0 +1,93 @@
+#ifndef MODULE_GRAPHICS_GEOMETRY_MESH_H_
+#define MODULE_GRAPHICS_GEOMETRY_MESH_H_
+
+#include <array>
+#include <vector>
+#include "defaults.h"
+#include "vec.h"
+#include "vec_array.h"
+#include "ray.h"
+#include "bounds.h"
+#include "intersection.h"
+
+namespace Geometry {
+
+    // Indexed triangle mesh: shared vertices and three vertex indices per triangle. Every
+    // triangle also keeps its first vertex and the two edges leaving it lane by lane, kept up
+    // to date as the mesh changes, so whole meshes are tested with Batch::Triangle.
+    class Mesh {
+
+    public:
+
+        // Closest hit, with the barycentrics of Intersection::TriangleHit
+        struct Hit {
+            float_max_t t, u, v;
+            unsigned triangle;
+            bool hit;
+
+            inline explicit operator bool (void) const { return this->hit; }
+        };
+
+    private:
+
+        VecArray<3> vertices;
+        std::vector<unsigned> indices;
+
+        // Followed by Simd::batchWidth - 1 degenerate triangles, so Batch::Triangle can read whole groups
+        VecArray<3> vertex_0, edge_1, edge_2;
+
+        void update (unsigned triangle);
+        void updateAll (void);
+
+    public:
+
+        Mesh (void) {}
+
+        // Three indices per triangle, throws std::invalid_argument on a bad index
+        Mesh (
+            const std::vector<Vec<3>> &_vertices,
+            const std::vector<unsigned> &_indices
+        );
+
+        unsigned addVertex (const Vec<3> &vertex);
+        unsigned addTriangle (unsigned index_0, unsigned index_1, unsigned index_2);
+
+        // Every triangle using the vertex follows it
+        void setVertex (unsigned vertex, const Vec<3> &position);
+
+        // Same matrix layout as VecArray::transform
+        void transform (const std::array<float_max_t, 16> &matrix, const Vec<3> &pivot = Vec<3>::zero);
+
+        void clear (void);
+
+        inline unsigned getVertexCount (void) const { return this->vertices.size(); }
+        inline unsigned getTriangleCount (void) const { return this->indices.size() / 3; }
+        inline bool empty (void) const { return this->indices.empty(); }
+
+        inline Vec<3> getVertex (unsigned vertex) const { return this->vertices.get(vertex); }
+        inline const VecArray<3> &getVertices (void) const { return this->vertices; }
+        inline const std::vector<unsigned> &getIndices (void) const { return this->indices; }
+
+        inline std::array<unsigned, 3> getTriangle (unsigned triangle) const {
+            return { this->indices[3 * triangle], this->indices[3 * triangle + 1], this->indices[3 * triangle + 2] };
+        }
+
+        inline Vec<3> getVertex (unsigned triangle, unsigned corner) const { return this->vertices.get(this->indices[3 * triangle + corner]); }
+
+        // Unit normal, counterclockwise vertices face it
+        Vec<3> getNormal (unsigned triangle) const;
+
+        // Point at barycentrics (u, v), as in Intersection::TriangleHit
+        Vec<3> getPoint (unsigned triangle, float_max_t u, float_max_t v) const;
+
+        AABB getBounds (unsigned triangle) const;
+        AABB getBounds (void) const;
+
+        Intersection::TriangleHit intersect (unsigned triangle, const Ray &ray) const;
+
+        Hit closest (const Ray &ray) const;
+        bool any (const Ray &ray) const;
+    };
+};
+
+#endif
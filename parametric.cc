@@ -25,7 +25,7 @@ namespace Geometry {
             const Vec<3> &point
         ) {
             const Vec<3> diff = point - sphere_center;
-            return { std::acos(clamp(diff[2] / sphere_radius, -1.0, 1.0)) * sphere_radius, std::atan2(diff[1], diff[0]) * sphere_radius };
+            return { std::acos(clamp<float_max_t>(diff[2] / sphere_radius, -1.0, 1.0)) * sphere_radius, std::atan2(diff[1], diff[0]) * sphere_radius };
         }
     };
 };
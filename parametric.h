@@ -7,6 +7,7 @@
 #include "vec.h"
 #include "quaternion.h"
 #include "plane.h"
+#include "cylinder.h"
 
 namespace Geometry {
 
@@ -25,6 +26,11 @@ namespace Geometry {
             const Vec<3> &point
         );
 
+        inline Vec<2> Cylinder (
+            const Geometry::Cylinder &cylinder,
+            const Vec<3> &point
+        ) { return cylinder.param(point); }
+
         Vec<2> Sphere (
             const Vec<3> &sphere_center,
             const float_max_t &sphere_radius,
@@ -1,9 +1,10 @@
+#include <thread>
 #include "plane.h"
 #include "intersection.h"
 
 namespace Geometry {
 
-    void Plane::calcForX (void) {
+    void Plane::calcForX (void) const {
         float_max_t norm = -1.0 / this->normal[0];
         this->point = { this->getD() * norm, 0.0, 0.0 };
         this->s_param = { this->normal[1] * norm, 1.0, 0.0 };
@@ -11,7 +12,7 @@ namespace Geometry {
         this->s_index = 1, this->t_index = 2;
     }
 
-    void Plane::calcForY (void) {
+    void Plane::calcForY (void) const {
         float_max_t norm = -1.0 / this->normal[1];
         this->point = { 0.0, this->getD() * norm, 0.0 };
         this->s_param = { 1.0, this->normal[0] * norm, 0.0 };
@@ -19,7 +20,7 @@ namespace Geometry {
         this->s_index = 0, this->t_index = 2;
     }
 
-    void Plane::calcForZ (void) {
+    void Plane::calcForZ (void) const {
         float_max_t norm = -1.0 / this->normal[2];
         this->point = { 0.0, 0.0, this->getD() * norm };
         this->s_param = { 1.0, 0.0, this->normal[0] * norm };
@@ -27,7 +28,7 @@ namespace Geometry {
         this->s_index = 0, this->t_index = 1;
     }
 
-    void Plane::calcParams (void) {
+    void Plane::calcParams (void) const {
         const float_max_t
             absx = std::abs(this->normal[0]),
             absy = std::abs(this->normal[1]),
@@ -46,6 +47,36 @@ namespace Geometry {
         }
     }
 
+    void Plane::parametrizeOnce (void) const {
+        unsigned char expected = UNPARAMETRIZED;
+        if (this->state.compare_exchange_strong(expected, PARAMETRIZING, std::memory_order_acquire)) {
+            this->calcParams();
+            this->state.store(PARAMETRIZED, std::memory_order_release);
+            return;
+        }
+        while (this->state.load(std::memory_order_acquire) != PARAMETRIZED) {
+            std::this_thread::yield();
+        }
+    }
+
+    Plane &Plane::operator= (const Plane &other) {
+        if (this == &other) {
+            return *this;
+        }
+        this->normal = other.normal;
+        this->d = other.d;
+        if (other.state.load(std::memory_order_acquire) == PARAMETRIZED) {
+            this->point = other.point;
+            this->s_param = other.s_param;
+            this->t_param = other.t_param;
+            this->s_index = other.s_index, this->t_index = other.t_index;
+            this->state.store(PARAMETRIZED, std::memory_order_relaxed);
+        } else {
+            this->state.store(UNPARAMETRIZED, std::memory_order_relaxed);
+        }
+        return *this;
+    }
+
     bool Plane::intersectLine (const Line &line, Vec<3> &normal, float_max_t &t_inter, bool fix_normal) const {
         if (Intersection::Line::Plane(line.getPoint(), line.getDirection(), *this, t_inter)) {
             if (fix_normal) {
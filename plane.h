@@ -1,41 +1,73 @@
 #ifndef MODULE_GRAPHICS_GEOMETRY_PLANE_H_
 #define MODULE_GRAPHICS_GEOMETRY_PLANE_H_
 
+#include <atomic>
 #include "vec.h"
 #include "line.h"
 
 namespace Geometry {
 
+    // The point and the (s, t) parametrization come from the normal and d. Lazy planes only
+    // compute them on first use, as most queries (and the polyhedron tests) never read them.
+    // The first reader computes them while concurrent readers wait, so lazy planes can be
+    // shared between threads as they are.
     class Plane {
 
-        unsigned s_index, t_index;
-        Vec<3> normal, point, s_param, t_param;
+        enum State : unsigned char { UNPARAMETRIZED, PARAMETRIZING, PARAMETRIZED };
+
+        mutable unsigned s_index, t_index;
+        Vec<3> normal;
+        mutable Vec<3> point, s_param, t_param;
         float_max_t d;
+        mutable std::atomic<unsigned char> state;
+
+        void calcForX (void) const;
+        void calcForY (void) const;
+        void calcForZ (void) const;
 
-        void calcForX (void);
-        void calcForY (void);
-        void calcForZ (void);
+        void calcParams (void) const;
 
-        void calcParams (void);
+        void parametrizeOnce (void) const;
 
     public:
 
+        struct Lazy {};
+
         Plane (const Vec<3> &_normal = Vec<3>::axisZ, const Vec<3> &_point = Vec<3>::origin) :
-            normal(_normal.normalized()), point(_point), d(_normal.dot(_point)) { this->calcParams(); }
+            normal(_normal.normalized()), point(_point), d(_normal.dot(_point)), state(PARAMETRIZED) { this->calcParams(); }
 
         Plane (const Vec<3> &_normal, float_max_t _d) :
-            normal(_normal.normalized()), d(_d) { this->calcParams(); }
+            normal(_normal.normalized()), d(_d), state(PARAMETRIZED) { this->calcParams(); }
+
+        Plane (const Vec<3> &_normal, float_max_t _d, Lazy) :
+            normal(_normal.normalized()), d(_d), state(UNPARAMETRIZED) {}
+
+        // A copy of a plane still being parametrized by another thread is left lazy
+        Plane (const Plane &other) :
+            normal(other.normal), d(other.d), state(UNPARAMETRIZED) { *this = other; }
+
+        Plane &operator= (const Plane &other);
+
+        inline void parametrize (void) const {
+            if (this->state.load(std::memory_order_acquire) != PARAMETRIZED) {
+                this->parametrizeOnce();
+            }
+        }
 
         inline const Vec<3> &getNormal (void) const { return this->normal; }
-        inline const Vec<3> &getPoint (void) const { return this->point; }
+        inline const Vec<3> &getPoint (void) const { this->parametrize(); return this->point; }
 
         inline float_max_t getA (void) const { return this->normal[0]; }
-        inline float_max_t getB (void) const { return this->normal[0]; }
-        inline float_max_t getC (void) const { return this->normal[0]; }
+        inline float_max_t getB (void) const { return this->normal[1]; }
+        inline float_max_t getC (void) const { return this->normal[2]; }
         inline float_max_t getD (void) const { return this->d; }
 
-        inline Vec<3> at (float_max_t s, float_max_t t) const { return this->getPoint() + s_param * s + t_param * t; }
-        inline Vec<2> param (const Vec<3> &point) const { return { point[this->s_index], point[this->t_index] }; };
+        inline Vec<3> at (float_max_t s, float_max_t t) const { this->parametrize(); return this->point + s_param * s + t_param * t; }
+        inline Vec<2> param (const Vec<3> &point) const { this->parametrize(); return { point[this->s_index], point[this->t_index] }; };
+
+        // The axes param reads s and t from
+        inline unsigned getSIndex (void) const { this->parametrize(); return this->s_index; }
+        inline unsigned getTIndex (void) const { this->parametrize(); return this->t_index; }
 
         inline bool inside (const Vec<3> &point) const { float_max_t result = this->normal.dot(point) - d; return closeToZero(result); }
 
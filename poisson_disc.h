@@ -6,46 +6,518 @@
 
 #include <random>
 #include <chrono>
+#include <limits>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
 #include "defaults.h"
+#include "type_traits.h"
 #include "vec.h"
+#include "thread_pool.h"
 
 namespace Geometry {
 
+    template <unsigned SIZE>
+    class PoissonDiscStream;
+
+    // Bridson's sampling over a box of SIZE dimensions, one point at a time from a single active
+    // queue, or all at once in parallel: the grid is split in tiles sampled in 2^SIZE phases by
+    // parity, so tiles sampled at the same time are a whole tile apart and never read what another
+    // one writes. Each tile has its own generator seeded from the seed and the tile, so the
+    // parallel result only depends on the seed.
+    template <unsigned SIZE>
     class PoissonDisc {
 
-        static std::mt19937 random_generator;
+        static_assert(SIZE > 0, "PoissonDisc size should be bigger than zero.");
+
+        // Shares the shell sampler and the cell layout
+        template <unsigned> friend class PoissonDiscStream;
+
+        // Cells are radius / sqrt(SIZE) wide, holding one point at most. Points closer than radius
+        // are at most reach cells away, candidates grown from a point at most halo cells away.
+        static constexpr unsigned
+            reach = static_ceil_sqrt<SIZE>::value,
+            halo = static_ceil_sqrt<4 * SIZE>::value;
+
+        // Side of a parallel tile in cells, more than a halo so same phase tiles never meet
+        static constexpr unsigned tile_cells = 32;
+
+        static_assert(halo < tile_cells, "PoissonDisc tiles should be wider than the halo.");
+
+        // Where the point of a cell is within it, in steps of 1 / cell_steps of the cell side along
+        // each axis, empty cells starting with empty_cell. Kept inline so the neighbourhood test never
+        // goes back to points, in a byte an axis so a 2D cell is half the int index of the old grid,
+        // and compared in whole steps so the test needs no conversions.
+        typedef std::array<std::uint8_t, SIZE> Cell;
+
+        static constexpr std::uint8_t empty_cell = 0xFF;
+        static constexpr std::int64_t cell_steps = 255;
+
+        // Two points in their steps are less than a step apart along each axis from where they are,
+        // so their distance is off by less than radius / cell_steps as radius is sqrt(SIZE) cell sides.
+        // Points are rejected that close to radius as well, under 1% of it, and no two points are
+        // ever closer.
+        static constexpr float_max_t slack = 1.0 + 4.0 / cell_steps;
+
+        // reach2 is the squared radius in steps, with the slack
+        const float_max_t radius, radius2, cell_size, inv_cell_size;
+        const std::int64_t reach2;
+        const Vec<SIZE> size;
+        const unsigned samples, seed;
 
-        const float_max_t radius, two_radius, radius2, width, height, cell_size, inv_cell_size;
-        const unsigned samples, grid_width, grid_height;
-        std::vector<Vec<2>> points;
+        std::mt19937 random_generator;
+
+        // Cells along each axis, and the distance between neighbours along it in the grid
+        std::array<unsigned, SIZE> grid_size;
+        std::array<std::size_t, SIZE> grid_stride;
+
+        std::vector<Vec<SIZE>> points;
         std::vector<int> queue;
-        std::vector<std::vector<int>> grid;
 
-        // This came from an ideia I had
-        // After benchmarking, I found out this is usually 10x faster than the default sin(random_angle), cos(random_angle)
-        static void randomSinCos (float_max_t &random_sin, float_max_t &random_cos);
+        // First axis first, in one allocation
+        std::vector<Cell> grid;
+
+        // Uniform in the volume of the shell between radius and 2 radius around center. Up to 4
+        // dimensions by rejection from the enclosing cube, which accepts at least 29% of the time
+        // and needs neither trigonometry nor roots. Past that, a normalized gaussian direction.
+        static Vec<SIZE> randomAround (std::mt19937 &generator, const Vec<SIZE> &center, float_max_t radius) {
+            const float_max_t two_radius = radius + radius, radius2 = radius * radius;
+            float_max_t r[SIZE];
+            const float_max_t *c = center.data();
+
+            if (SIZE <= 4) {
+                std::uniform_real_distribution<float_max_t> coordinate(-two_radius, two_radius);
+                const float_max_t outer2 = 4.0 * radius2;
+                float_max_t length2;
+                do {
+                    length2 = 0.0;
+                    for (unsigned i = 0; i < SIZE; ++i) {
+                        r[i] = coordinate(generator);
+                        length2 += r[i] * r[i];
+                    }
+                } while (length2 < radius2 || length2 >= outer2);
+            } else {
+                std::normal_distribution<float_max_t> coordinate;
+                std::uniform_real_distribution<float_max_t> volume(1.0, std::pow(2.0, SIZE));
+                float_max_t length2;
+                do {
+                    length2 = 0.0;
+                    for (unsigned i = 0; i < SIZE; ++i) {
+                        r[i] = coordinate(generator);
+                        length2 += r[i] * r[i];
+                    }
+                } while (length2 == 0.0);
+                const float_max_t scale = radius * std::pow(volume(generator), 1.0 / SIZE) / std::sqrt(length2);
+                for (unsigned i = 0; i < SIZE; ++i) {
+                    r[i] *= scale;
+                }
+            }
+
+            for (unsigned i = 0; i < SIZE; ++i) {
+                r[i] += c[i];
+            }
+            return Vec<SIZE>(r, r + SIZE);
+        }
+
+        // Where the point is in the given cell, in cell sides
+        template <typename INDEX>
+        inline static void offsetsOf (const Vec<SIZE> &point, float_max_t inv_cell_size, const INDEX *cell, float_max_t *offsets) {
+            const float_max_t *p = point.data();
+            for (unsigned i = 0; i < SIZE; ++i) {
+                offsets[i] = p[i] * inv_cell_size - static_cast<float_max_t>(cell[i]);
+            }
+        }
+
+        inline static Cell toCell (const float_max_t *offsets) {
+            Cell result;
+            for (unsigned i = 0; i < SIZE; ++i) {
+                const float_max_t step = std::floor(offsets[i] * cell_steps);
+                result[i] = step <= 0.0 ? 0 : step >= cell_steps ? empty_cell - 1 : static_cast<std::uint8_t>(step);
+            }
+            return result;
+        }
+
+        // The squared radius in steps, with the slack
+        inline static std::int64_t reachOf (float_max_t radius, float_max_t inv_cell_size) {
+            const float_max_t steps = radius * inv_cell_size * cell_steps;
+            return static_cast<std::int64_t>(std::ceil(steps * steps * slack));
+        }
+
+        // Samples filling the box, for reserving them ahead. Balls of half the radius around them
+        // are disjoint and within the box grown by half the radius, and random sampling stops
+        // short of the fraction of it random sequential addition saturates at.
+        std::size_t expectedCount (void) const {
+            static const float_max_t saturation[] = { 0.7476, 0.5471, 0.3841, 0.2595, 0.1698, 0.1076 };
+            const float_max_t half = 0.5 * this->radius;
+            float_max_t box = 1.0, ball = std::pow(PI, 0.5 * SIZE) / std::tgamma(0.5 * SIZE + 1.0);
+            for (unsigned i = 0; i < SIZE; ++i) {
+                box *= this->size.data()[i] + this->radius;
+                ball *= half;
+            }
+            return static_cast<std::size_t>(saturation[std::min(SIZE, 6u) - 1] * box / ball) + 1;
+        }
+
+        inline static Cell emptyCell (void) {
+            Cell result;
+            result.fill(empty_cell);
+            return result;
+        }
+
+        // Whether a full cell of the line at, from first to last, is closer than reach2 steps to the
+        // point of query in cell. The whole run is tested without branching, as about as many cells
+        // are empty as full.
+        inline static bool closeInLine (
+            const Cell *line, const unsigned *at, unsigned first, unsigned last,
+            const unsigned *cell, const Cell &query, std::int64_t reach2
+        ) {
+            std::int64_t base[SIZE];
+            for (unsigned i = 0; i < SIZE; ++i) {
+                base[i] = (static_cast<std::int64_t>(i == 0 ? first : at[i]) - cell[i]) * cell_steps - query[i];
+            }
+
+            bool close = false;
+            for (unsigned x = first; x < last; ++x, base[0] += cell_steps) {
+                const Cell &other = line[x];
+                std::int64_t distance2 = 0;
+                for (unsigned i = 0; i < SIZE; ++i) {
+                    const std::int64_t diff = base[i] + other[i];
+                    distance2 += diff * diff;
+                }
+                close |= (other[0] != empty_cell) & (distance2 < reach2);
+            }
+            return close;
+        }
+
+        // The cell of a point of the box, false out of it
+        bool cellOf (const Vec<SIZE> &point, unsigned *cell) const {
+            const float_max_t *p = point.data(), *s = this->size.data();
+            for (unsigned i = 0; i < SIZE; ++i) {
+                if (!(0.0 <= p[i] && p[i] < s[i])) {
+                    return false;
+                }
+                cell[i] = std::min(static_cast<unsigned>(p[i] * this->inv_cell_size), this->grid_size[i] - 1);
+            }
+            return true;
+        }
+
+        inline std::size_t index (const unsigned *cell) const {
+            std::size_t result = 0;
+            for (unsigned i = 0; i < SIZE; ++i) {
+                result += cell[i] * this->grid_stride[i];
+            }
+            return result;
+        }
+
+        // Runs of cells along the first axis, the rest of the neighbourhood stepped like an odometer
+        bool validPoint (const Vec<SIZE> &point, const unsigned *cell) const {
+            unsigned min[SIZE], max[SIZE], at[SIZE];
+            for (unsigned i = 0; i < SIZE; ++i) {
+                min[i] = at[i] = cell[i] > reach ? (cell[i] - reach) : 0;
+                max[i] = std::min(cell[i] + reach + 1, this->grid_size[i]);
+            }
+            at[0] = 0; // Lines start at the beginning of the first axis
+
+            float_max_t offsets[SIZE];
+            PoissonDisc<SIZE>::offsetsOf(point, this->inv_cell_size, cell, offsets);
+            const Cell query = PoissonDisc<SIZE>::toCell(offsets);
+
+            for (;;) {
+                const Cell *line = this->grid.data() + this->index(at);
+
+                if (PoissonDisc<SIZE>::closeInLine(line, at, min[0], max[0], cell, query, this->reach2)) {
+                    return false;
+                }
+
+                unsigned axis = 1;
+                for (; axis < SIZE; ++axis) {
+                    if (++at[axis] < max[axis]) {
+                        break;
+                    }
+                    at[axis] = min[axis];
+                }
+                if (axis == SIZE) {
+                    return true;
+                }
+            }
+        }
+
+        inline void setCell (const Vec<SIZE> &point, const unsigned *cell) {
+            float_max_t offsets[SIZE];
+            PoissonDisc<SIZE>::offsetsOf(point, this->inv_cell_size, cell, offsets);
+            this->grid[this->index(cell)] = PoissonDisc<SIZE>::toCell(offsets);
+        }
+
+        void addPoint (const Vec<SIZE> &point, const unsigned *cell) {
+            unsigned position = this->points.size();
+            this->points.push_back(point);
+            this->queue.push_back(position);
+            this->setCell(point, cell);
+        }
+
+        // Bridson's loop inside one tile, from the points already within reach of it, or a random
+        // point of the tile when there are none. Only cells of the tile are written, and only cells
+        // up to halo away from it read, which no other tile of the same phase writes.
+        void sampleTile (const std::array<unsigned, SIZE> &tile, std::vector<Vec<SIZE>> &tile_points) {
+            unsigned min[SIZE], max[SIZE], at[SIZE];
+            for (unsigned i = 0; i < SIZE; ++i) {
+                min[i] = tile[i] * PoissonDisc<SIZE>::tile_cells;
+                max[i] = std::min(min[i] + PoissonDisc<SIZE>::tile_cells, this->grid_size[i]);
+            }
+
+            std::vector<unsigned> seeds = { this->seed };
+            seeds.insert(seeds.end(), tile.begin(), tile.end());
+            std::seed_seq sequence(seeds.begin(), seeds.end());
+            std::mt19937 generator(sequence);
+
+            std::vector<Vec<SIZE>> active;
 
-        bool validPoint (const Vec<2> &point);
-        void addPoint (const Vec<2> &point);
+            unsigned around_min[SIZE], around_max[SIZE];
+            for (unsigned i = 0; i < SIZE; ++i) {
+                around_min[i] = at[i] = min[i] > halo ? (min[i] - halo) : 0;
+                around_max[i] = std::min(max[i] + halo, this->grid_size[i]);
+            }
+            at[0] = 0; // Lines start at the beginning of the first axis
+            for (;;) {
+                const Cell *line = this->grid.data() + this->index(at);
+                for (at[0] = around_min[0]; at[0] < around_max[0]; ++at[0]) {
+                    // Up to half a step away from the point, the candidates grown from it being tested all the same
+                    const Cell &other = line[at[0]];
+                    if (other[0] != empty_cell) {
+                        float_max_t coordinates[SIZE];
+                        for (unsigned i = 0; i < SIZE; ++i) {
+                            coordinates[i] = (at[i] + (other[i] + 0.5) / cell_steps) * this->cell_size;
+                        }
+                        active.emplace_back(coordinates, coordinates + SIZE);
+                    }
+                }
+                at[0] = 0;
+
+                unsigned axis = 1;
+                for (; axis < SIZE; ++axis) {
+                    if (++at[axis] < around_max[axis]) {
+                        break;
+                    }
+                    at[axis] = around_min[axis];
+                }
+                if (axis == SIZE) {
+                    break;
+                }
+            }
+
+            // Membership by cell, so a point on the edge never lands in the cell of a neighbour
+            unsigned cell[SIZE];
+            const auto inside = [ this, &min, &max, &cell ] (const Vec<SIZE> &point) {
+                if (!this->cellOf(point, cell)) {
+                    return false;
+                }
+                for (unsigned i = 0; i < SIZE; ++i) {
+                    if (cell[i] < min[i] || cell[i] >= max[i]) {
+                        return false;
+                    }
+                }
+                return true;
+            };
+
+            const auto add = [ this, &active, &tile_points, &cell ] (const Vec<SIZE> &point) {
+                this->setCell(point, cell);
+                tile_points.push_back(point);
+                active.push_back(point);
+            };
+
+            if (active.empty()) {
+                for (unsigned sample = 0; sample < this->samples && active.empty(); ++sample) {
+                    float_max_t coordinates[SIZE];
+                    for (unsigned i = 0; i < SIZE; ++i) {
+                        std::uniform_real_distribution<float_max_t> position(
+                            min[i] * this->cell_size,
+                            std::min(max[i] * this->cell_size, this->size.data()[i])
+                        );
+                        coordinates[i] = position(generator);
+                    }
+                    const Vec<SIZE> point(coordinates, coordinates + SIZE);
+                    if (inside(point) && this->validPoint(point, cell)) {
+                        add(point);
+                    }
+                }
+            }
+
+            while (!active.empty()) {
+                const Vec<SIZE> close = active.back();
+                bool found = false;
+
+                for (unsigned i = 0; i < this->samples; ++i) {
+                    const Vec<SIZE> point = PoissonDisc<SIZE>::randomAround(generator, close, this->radius);
+
+                    if (inside(point) && this->validPoint(point, cell)) {
+                        add(point);
+                        found = true;
+                        break;
+                    }
+                }
+
+                if (!found) {
+                    active.pop_back();
+                }
+            }
+        }
 
     public:
 
-        PoissonDisc (const float_max_t &_radius, const float_max_t &_width = 1.0, const float_max_t &_height = 1.0, const unsigned &_samples = 10) :
-            radius(_radius), two_radius(_radius + _radius), radius2(_radius * _radius),
-            width(_width), height(_height),
-            cell_size(_radius * SQRT_2_INV), inv_cell_size(1.0 / cell_size),
-            samples(_samples),
-            grid_width(std::ceil(_width * inv_cell_size)), grid_height(std::ceil(_height * inv_cell_size)),
-            grid(grid_height, std::vector<int>(grid_width, -1))
-        {}
+        // The box spans [0, size) along each axis. Without a seed, the clock is used.
+        PoissonDisc (
+            const float_max_t &_radius,
+            const Vec<SIZE> &_size = Vec<SIZE>(1.0),
+            const unsigned &_samples = 10,
+            const unsigned &_seed = static_cast<unsigned>(std::chrono::system_clock::now().time_since_epoch().count())
+        ) :
+            radius(_radius), radius2(_radius * _radius),
+            cell_size(_radius / std::sqrt(static_cast<float_max_t>(SIZE))), inv_cell_size(1.0 / cell_size),
+            reach2(PoissonDisc<SIZE>::reachOf(_radius, inv_cell_size)),
+            size(_size), samples(_samples), seed(_seed), random_generator(_seed)
+        {
+            std::size_t cells = 1;
+            for (unsigned i = 0; i < SIZE; ++i) {
+                this->grid_size[i] = std::max(static_cast<unsigned>(std::ceil(_size.data()[i] * this->inv_cell_size)), 1u);
+                this->grid_stride[i] = cells;
+                cells *= this->grid_size[i];
+            }
+            this->grid.assign(cells, PoissonDisc<SIZE>::emptyCell());
+        }
+
+        // The old 2D shape, over [0, width) x [0, height)
+        template <unsigned DIMENSION = SIZE, typename = typename std::enable_if<DIMENSION == 2>::type>
+        PoissonDisc (
+            const float_max_t &_radius,
+            const float_max_t &_width,
+            const float_max_t &_height = 1.0,
+            const unsigned &_samples = 10,
+            const unsigned &_seed = static_cast<unsigned>(std::chrono::system_clock::now().time_since_epoch().count())
+        ) : PoissonDisc<SIZE>(_radius, Vec<SIZE>{ _width, _height }, _samples, _seed) {}
+
+        bool operator() (Vec<SIZE> &next_point) {
+            unsigned cell[SIZE];
+
+            if (this->points.empty()) {
+                float_max_t coordinates[SIZE];
+                for (unsigned i = 0; i < SIZE; ++i) {
+                    std::uniform_real_distribution<float_max_t> position(0.0, this->size.data()[i]);
+                    coordinates[i] = position(this->random_generator);
+                }
+                next_point = Vec<SIZE>(coordinates, coordinates + SIZE);
+                if (!this->cellOf(next_point, cell)) {
+                    return false;
+                }
+                this->addPoint(next_point, cell);
+                return true;
+            }
+
+            std::vector<int>::reverse_iterator next;
+
+            for (auto it = this->queue.rbegin(); it != this->queue.rend(); it = next) {
+                const Vec<SIZE> close = this->points[*it];
+
+                for (unsigned i = 0; i < this->samples; ++i) {
+                    const Vec<SIZE> point = PoissonDisc<SIZE>::randomAround(this->random_generator, close, this->radius);
+
+                    if (this->cellOf(point, cell) && this->validPoint(point, cell)) {
+                        next_point = point;
+                        this->addPoint(point, cell);
+                        return true;
+                    }
+                }
+
+                next = std::next(it);
 
-        bool operator() (Vec<2> &next_point);
+                std::swap(*it, this->queue.back());
+                this->queue.pop_back();
+            }
 
-        inline const std::vector<Vec<2>> &getPoints (void) const { return this->points; }
-        const std::vector<Vec<2>> &allPoints (void);
+            return false;
+        }
 
+        inline const std::vector<Vec<SIZE>> &getPoints (void) const { return this->points; }
+        inline unsigned getSeed (void) const { return this->seed; }
+
+        // Points are reserved ahead, not the queue, as only the frontier is ever in it
+        const std::vector<Vec<SIZE>> &allPoints (void) {
+            this->points.reserve(this->expectedCount());
+
+            Vec<SIZE> point;
+            while ((*this)(point));
+            return this->points;
+        }
+
+        // Fills the box in parallel, growing around the points already there. Points come
+        // tile after tile, phase after phase, the same for a seed whatever the number of threads.
+        const std::vector<Vec<SIZE>> &allPoints (ThreadPool &pool) {
+            std::array<unsigned, SIZE> tiles_count;
+            for (unsigned i = 0; i < SIZE; ++i) {
+                tiles_count[i] = (this->grid_size[i] + PoissonDisc<SIZE>::tile_cells - 1) / PoissonDisc<SIZE>::tile_cells;
+            }
+            this->points.reserve(this->expectedCount());
+
+            for (unsigned phase = 0; phase < (1u << SIZE); ++phase) {
+                std::vector<std::array<unsigned, SIZE>> tiles;
+                std::array<unsigned, SIZE> first, at;
+                bool empty = false;
+                for (unsigned i = 0; i < SIZE; ++i) {
+                    first[i] = at[i] = (phase >> i) & 1u;
+                    empty = empty || first[i] >= tiles_count[i];
+                }
+
+                while (!empty) {
+                    tiles.push_back(at);
+
+                    unsigned axis = 0;
+                    for (; axis < SIZE; ++axis) {
+                        if ((at[axis] += 2) < tiles_count[axis]) {
+                            break;
+                        }
+                        at[axis] = first[axis];
+                    }
+                    empty = axis == SIZE;
+                }
+
+                std::vector<std::vector<Vec<SIZE>>> tile_points(tiles.size());
+                pool.parallelForDynamic(0, tiles.size(), 1, [ this, &tiles, &tile_points ] (std::size_t from, std::size_t to) {
+                    for (std::size_t i = from; i < to; ++i) {
+                        this->sampleTile(tiles[i], tile_points[i]);
+                    }
+                });
+
+                for (const std::vector<Vec<SIZE>> &tile : tile_points) {
+                    this->points.insert(this->points.end(), tile.begin(), tile.end());
+                }
+            }
+
+            // Every point was grown from until it had no room left
+            this->queue.clear();
+
+            return this->points;
+        }
     };
 
+    template <unsigned SIZE>
+    constexpr unsigned PoissonDisc<SIZE>::reach;
+
+    template <unsigned SIZE>
+    constexpr unsigned PoissonDisc<SIZE>::halo;
+
+    template <unsigned SIZE>
+    constexpr unsigned PoissonDisc<SIZE>::tile_cells;
+
+    template <unsigned SIZE>
+    constexpr std::uint8_t PoissonDisc<SIZE>::empty_cell;
+
+    template <unsigned SIZE>
+    constexpr std::int64_t PoissonDisc<SIZE>::cell_steps;
+
+    template <unsigned SIZE>
+    constexpr float_max_t PoissonDisc<SIZE>::slack;
+
 }
 
 
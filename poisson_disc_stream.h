@@ -0,0 +1,532 @@
+#ifndef MODULE_GEOMETRY_POISSON_DISC_STREAM_H_
+#define MODULE_GEOMETRY_POISSON_DISC_STREAM_H_
+
+#include <random>
+#include <chrono>
+#include <limits>
+#include <array>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <cstdint>
+#include "defaults.h"
+#include "vec.h"
+#include "poisson_disc.h"
+
+namespace Geometry {
+
+    // Poisson-disc sampling of all of space, a tile at a time as queries reach it. Every tile is
+    // first sampled on its own, then its points are those samples made to agree with the samples
+    // of the 3^SIZE - 1 tiles around, phased by the parity of their coordinates like in
+    // PoissonDisc::allPoints. A tile is so a function of the seed and of the coordinates of the
+    // tiles next to it alone: queries can come in any order, never sample further than a tile
+    // around them, and a tile evicted to stay under the memory budget comes back the same, seamless
+    // with the neighbours generated meanwhile.
+    template <unsigned SIZE>
+    class PoissonDiscStream {
+
+        static constexpr unsigned
+            reach = PoissonDisc<SIZE>::reach,
+            halo = PoissonDisc<SIZE>::halo,
+            tile_cells = PoissonDisc<SIZE>::tile_cells,
+            region_cells = tile_cells + 2 * halo;
+
+        typedef std::array<std::int64_t, SIZE> Index;
+        typedef typename PoissonDisc<SIZE>::Cell Cell;
+
+        // Only the points are kept, a tile being sampled again when evicted. The points of a
+        // tile come from its raw samples and those of its neighbours once it is queried.
+        struct Tile {
+            std::vector<Vec<SIZE>> raw, points;
+            bool generated = false;
+            std::size_t memory = 0;
+        };
+
+        // reach2 as in PoissonDisc
+        const float_max_t radius, radius2, cell_size, inv_cell_size;
+        const std::int64_t reach2;
+        const unsigned samples, seed;
+        std::size_t budget, memory;
+
+        std::map<Index, Tile> tiles;
+
+        // A tile and its halo, allocated by the first tile sampled. Only the cells written for a
+        // tile are cleared after it, the rest staying empty.
+        std::vector<Cell> region;
+        std::vector<std::size_t> written;
+
+        inline static std::int64_t floorDiv (std::int64_t value, std::int64_t divisor) {
+            return value >= 0 ? value / divisor : -((divisor - 1 - value) / divisor);
+        }
+
+        inline static unsigned phase (const Index &tile) {
+            unsigned result = 0;
+            for (unsigned i = 0; i < SIZE; ++i) {
+                result |= static_cast<unsigned>(tile[i] & 1) << i;
+            }
+            return result;
+        }
+
+        // The one rounding every cell comes from, so tiles agree on where their points are
+        inline Index cellOf (const Vec<SIZE> &point) const {
+            Index result;
+            const float_max_t *p = point.data();
+            for (unsigned i = 0; i < SIZE; ++i) {
+                result[i] = static_cast<std::int64_t>(std::floor(p[i] * this->inv_cell_size));
+            }
+            return result;
+        }
+
+        inline Index tileOf (const Index &cell) const {
+            Index result;
+            for (unsigned i = 0; i < SIZE; ++i) {
+                result[i] = PoissonDiscStream<SIZE>::floorDiv(cell[i], tile_cells);
+            }
+            return result;
+        }
+
+        // Local cell of the region from origin, false out of it
+        inline static bool local (const Index &cell, const Index &origin, unsigned *result) {
+            for (unsigned i = 0; i < SIZE; ++i) {
+                const std::int64_t position = cell[i] - origin[i];
+                if (position < 0 || position >= region_cells) {
+                    return false;
+                }
+                result[i] = static_cast<unsigned>(position);
+            }
+            return true;
+        }
+
+        inline static std::size_t index (const unsigned *cell) {
+            std::size_t result = 0, stride = 1;
+            for (unsigned i = 0; i < SIZE; ++i) {
+                result += cell[i] * stride;
+                stride *= region_cells;
+            }
+            return result;
+        }
+
+        // Fills the local cell of a point, global being its cell in space
+        inline void setCell (const Vec<SIZE> &point, const Index &global, const unsigned *cell) {
+            float_max_t offsets[SIZE];
+            PoissonDisc<SIZE>::offsetsOf(point, this->inv_cell_size, global.data(), offsets);
+            const std::size_t position = PoissonDiscStream<SIZE>::index(cell);
+            this->region[position] = PoissonDisc<SIZE>::toCell(offsets);
+            this->written.push_back(position);
+        }
+
+        // Same odometer as PoissonDisc::validPoint, over the region
+        bool validPoint (const Vec<SIZE> &point, const Index &global, const unsigned *cell) const {
+            unsigned min[SIZE], max[SIZE], at[SIZE];
+            for (unsigned i = 0; i < SIZE; ++i) {
+                min[i] = at[i] = cell[i] > reach ? (cell[i] - reach) : 0;
+                max[i] = std::min(cell[i] + reach + 1, region_cells);
+            }
+            at[0] = 0; // Lines start at the beginning of the first axis
+
+            float_max_t offsets[SIZE];
+            PoissonDisc<SIZE>::offsetsOf(point, this->inv_cell_size, global.data(), offsets);
+            const Cell query = PoissonDisc<SIZE>::toCell(offsets);
+
+            for (;;) {
+                const Cell *line = this->region.data() + PoissonDiscStream<SIZE>::index(at);
+
+                if (PoissonDisc<SIZE>::closeInLine(line, at, min[0], max[0], cell, query, this->reach2)) {
+                    return false;
+                }
+
+                unsigned axis = 1;
+                for (; axis < SIZE; ++axis) {
+                    if (++at[axis] < max[axis]) {
+                        break;
+                    }
+                    at[axis] = min[axis];
+                }
+                if (axis == SIZE) {
+                    return true;
+                }
+            }
+        }
+
+        // The 3^SIZE - 1 tiles around, in a fixed order
+        template <typename FUNCTION>
+        static void forEachNeighbour (const Index &tile, const FUNCTION &function) {
+            int offset[SIZE];
+            std::fill(offset, offset + SIZE, -1);
+            for (;;) {
+                bool self = true;
+                Index neighbour;
+                for (unsigned i = 0; i < SIZE; ++i) {
+                    neighbour[i] = tile[i] + offset[i];
+                    self = self && offset[i] == 0;
+                }
+                if (!self) {
+                    function(neighbour);
+                }
+
+                unsigned axis = 0;
+                for (; axis < SIZE; ++axis) {
+                    if (++offset[axis] <= 1) {
+                        break;
+                    }
+                    offset[axis] = -1;
+                }
+                if (axis == SIZE) {
+                    return;
+                }
+            }
+        }
+
+        // From the seed, the tile and which of its two passes
+        std::mt19937 generatorOf (const Index &tile, unsigned pass) const {
+            std::vector<unsigned> seeds = { this->seed };
+            for (unsigned i = 0; i < SIZE; ++i) {
+                const std::uint64_t coordinate = static_cast<std::uint64_t>(tile[i]);
+                seeds.push_back(static_cast<unsigned>(coordinate));
+                seeds.push_back(static_cast<unsigned>(coordinate >> 32));
+            }
+            seeds.push_back(pass);
+            std::seed_seq sequence(seeds.begin(), seeds.end());
+            return std::mt19937(sequence);
+        }
+
+        inline Index originOf (const Index &tile) const {
+            Index origin;
+            for (unsigned i = 0; i < SIZE; ++i) {
+                origin[i] = tile[i] * tile_cells - halo;
+            }
+            return origin;
+        }
+
+        // Sets the cells of the points in the region, adding them to active when given
+        void place (const std::vector<Vec<SIZE>> &points, const Index &origin, std::vector<Vec<SIZE>> *active) {
+            unsigned cell[SIZE];
+            for (const Vec<SIZE> &point : points) {
+                const Index global = this->cellOf(point);
+                if (PoissonDiscStream<SIZE>::local(global, origin, cell)) {
+                    this->setCell(point, global, cell);
+                    if (active != nullptr) {
+                        active->push_back(point);
+                    }
+                }
+            }
+        }
+
+        // Bridson's loop from the active points, adding those accepted by inside, which also sets
+        // global and cell. From a random point of the tile when there are none.
+        template <typename INSIDE>
+        void grow (
+            std::mt19937 &generator, const Index &tile, const INSIDE &inside, Index &global, unsigned *cell,
+            std::vector<Vec<SIZE>> &active, std::vector<Vec<SIZE>> &points
+        ) {
+            const auto add = [ this, &active, &points, &global, cell ] (const Vec<SIZE> &point) {
+                this->setCell(point, global, cell);
+                points.push_back(point);
+                active.push_back(point);
+            };
+
+            if (active.empty()) {
+                for (unsigned sample = 0; sample < this->samples && active.empty(); ++sample) {
+                    float_max_t coordinates[SIZE];
+                    for (unsigned i = 0; i < SIZE; ++i) {
+                        const float_max_t start = tile[i] * static_cast<float_max_t>(tile_cells) * this->cell_size;
+                        std::uniform_real_distribution<float_max_t> position(start, start + tile_cells * this->cell_size);
+                        coordinates[i] = position(generator);
+                    }
+                    const Vec<SIZE> point(coordinates, coordinates + SIZE);
+                    if (inside(point) && this->validPoint(point, global, cell)) {
+                        add(point);
+                    }
+                }
+            }
+
+            while (!active.empty()) {
+                const Vec<SIZE> close = active.back();
+                bool added = false;
+
+                for (unsigned i = 0; i < this->samples; ++i) {
+                    const Vec<SIZE> point = PoissonDisc<SIZE>::randomAround(generator, close, this->radius);
+
+                    if (inside(point) && this->validPoint(point, global, cell)) {
+                        add(point);
+                        added = true;
+                        break;
+                    }
+                }
+
+                if (!added) {
+                    active.pop_back();
+                }
+            }
+        }
+
+        // Only the cells written are cleared, the rest staying empty
+        inline void clearRegion (void) {
+            for (const std::size_t position : this->written) {
+                this->region[position] = PoissonDisc<SIZE>::emptyCell();
+            }
+            this->written.clear();
+        }
+
+        inline void account (Tile &tile) {
+            this->memory -= tile.memory;
+            tile.memory = sizeof(Index) + sizeof(Tile) + 4 * sizeof(void *) +
+                (tile.raw.capacity() + tile.points.capacity()) * sizeof(Vec<SIZE>);
+            this->memory += tile.memory;
+        }
+
+        // The tile sampled on its own, from the seed and its coordinates alone
+        Tile &sample (const Index &tile) {
+            const auto found = this->tiles.find(tile);
+            if (found != this->tiles.end()) {
+                return found->second;
+            }
+
+            if (this->region.empty()) {
+                std::size_t cells = 1;
+                for (unsigned i = 0; i < SIZE; ++i) {
+                    cells *= region_cells;
+                }
+                this->region.assign(cells, PoissonDisc<SIZE>::emptyCell());
+            }
+
+            const Index origin = this->originOf(tile);
+            std::mt19937 generator = this->generatorOf(tile, 0);
+            std::vector<Vec<SIZE>> active, points;
+            Index global;
+            unsigned cell[SIZE];
+
+            // Membership by cell, so a point on the edge never lands in the cell of a neighbour
+            const auto inside = [ this, &tile, &origin, &global, &cell ] (const Vec<SIZE> &point) {
+                global = this->cellOf(point);
+                return this->tileOf(global) == tile && PoissonDiscStream<SIZE>::local(global, origin, cell);
+            };
+            this->grow(generator, tile, inside, global, cell, active, points);
+            this->clearRegion();
+
+            points.shrink_to_fit();
+
+            Tile &result = this->tiles[tile];
+            result.raw = std::move(points);
+            this->account(result);
+            return result;
+        }
+
+        // From the samples of the tile and of its neighbours only, so a tile never needs more than
+        // the 3^SIZE around it. The samples closer than radius to those of a lower phase neighbour
+        // are dropped, as the neighbour keeps all of them, and the room left along the sides is
+        // filled again by Bridson's loop, away from the samples of every neighbour and half a
+        // radius inside the tile. Two tiles so never hold points closer than radius: one of them
+        // avoided the samples the other kept, or both filled in at least half a radius from a side.
+        const Tile &generate (const Index &tile) {
+            Tile &found = this->sample(tile);
+            if (found.generated) {
+                return found;
+            }
+
+            const unsigned tile_phase = PoissonDiscStream<SIZE>::phase(tile);
+            PoissonDiscStream<SIZE>::forEachNeighbour(tile, [ this ] (const Index &neighbour) {
+                this->sample(neighbour);
+            });
+
+            const Index origin = this->originOf(tile);
+            PoissonDiscStream<SIZE>::forEachNeighbour(tile, [ this, tile_phase, &origin ] (const Index &neighbour) {
+                if (PoissonDiscStream<SIZE>::phase(neighbour) < tile_phase) {
+                    this->place(this->tiles.at(neighbour).raw, origin, nullptr);
+                }
+            });
+
+            Tile &result = this->tiles.at(tile);
+            std::vector<Vec<SIZE>> points, active;
+            Index global;
+            unsigned cell[SIZE];
+            for (const Vec<SIZE> &point : result.raw) {
+                global = this->cellOf(point);
+                if (PoissonDiscStream<SIZE>::local(global, origin, cell) && this->validPoint(point, global, cell)) {
+                    this->setCell(point, global, cell);
+                    points.push_back(point);
+                }
+            }
+
+            // Growing from the points within two halos of the sides reaches every sample dropped
+            PoissonDiscStream<SIZE>::forEachNeighbour(tile, [ this, &origin, &active ] (const Index &neighbour) {
+                this->place(this->tiles.at(neighbour).raw, origin, &active);
+            });
+            for (const Vec<SIZE> &point : points) {
+                PoissonDiscStream<SIZE>::local(this->cellOf(point), origin, cell);
+                bool side = false;
+                for (unsigned i = 0; i < SIZE; ++i) {
+                    side = side || cell[i] < 3 * halo || cell[i] >= tile_cells - halo;
+                }
+                if (side) {
+                    active.push_back(point);
+                }
+            }
+
+            const float_max_t margin = 0.5 * this->radius * PoissonDisc<SIZE>::slack * this->inv_cell_size;
+            const auto inside = [ this, &tile, &origin, &global, &cell, margin ] (const Vec<SIZE> &point) {
+                global = this->cellOf(point);
+                if (this->tileOf(global) != tile || !PoissonDiscStream<SIZE>::local(global, origin, cell)) {
+                    return false;
+                }
+                const float_max_t *p = point.data();
+                for (unsigned i = 0; i < SIZE; ++i) {
+                    const float_max_t offset = p[i] * this->inv_cell_size - static_cast<float_max_t>(tile[i] * tile_cells);
+                    if (offset < margin || offset > tile_cells - margin) {
+                        return false;
+                    }
+                }
+                return true;
+            };
+            if (!active.empty()) {
+                std::mt19937 generator = this->generatorOf(tile, 1);
+                this->grow(generator, tile, inside, global, cell, active, points);
+            }
+            this->clearRegion();
+
+            points.shrink_to_fit();
+
+            result.points = std::move(points);
+            result.generated = true;
+            this->account(result);
+            return result;
+        }
+
+        // Tiles out of [first, last] furthest from its center first, until under the budget
+        void evict (const Index &first, const Index &last) {
+            if (this->getMemory() <= this->budget) {
+                return;
+            }
+
+            std::vector<std::pair<float_max_t, typename std::map<Index, Tile>::iterator>> candidates;
+            for (auto it = this->tiles.begin(); it != this->tiles.end(); ++it) {
+                float_max_t distance2 = 0.0;
+                bool inside = true;
+                for (unsigned i = 0; i < SIZE; ++i) {
+                    const std::int64_t coordinate = it->first[i];
+                    inside = inside && first[i] <= coordinate && coordinate <= last[i];
+                    const float_max_t diff = 2.0 * coordinate - first[i] - last[i];
+                    distance2 += diff * diff;
+                }
+                if (!inside) {
+                    candidates.emplace_back(distance2, it);
+                }
+            }
+
+            std::sort(candidates.begin(), candidates.end(), [] (const auto &a, const auto &b) {
+                return a.first > b.first;
+            });
+
+            for (const auto &candidate : candidates) {
+                if (this->getMemory() <= this->budget) {
+                    break;
+                }
+                this->memory -= candidate.second->second.memory;
+                this->tiles.erase(candidate.second);
+            }
+        }
+
+    public:
+
+        // The budget, in bytes, bounds the points and bookkeeping of the tiles kept between
+        // queries along with the region tiles are generated in, (32 + 2 * halo)^SIZE cells of
+        // SIZE 8-bit offsets: about 3 KB in 2D, 190 KB in 3D and 10 MB in 4D. Tiles a query
+        // overlaps are always kept, even over budget.
+        // Without a seed, the clock is used.
+        PoissonDiscStream (
+            const float_max_t &_radius,
+            std::size_t _budget = 64u << 20,
+            const unsigned &_samples = 10,
+            const unsigned &_seed = static_cast<unsigned>(std::chrono::system_clock::now().time_since_epoch().count())
+        ) :
+            radius(_radius), radius2(_radius * _radius),
+            cell_size(_radius / std::sqrt(static_cast<float_max_t>(SIZE))), inv_cell_size(1.0 / cell_size),
+            reach2(PoissonDisc<SIZE>::reachOf(_radius, inv_cell_size)),
+            samples(_samples), seed(_seed), budget(_budget), memory(0)
+        {}
+
+        inline float_max_t getRadius (void) const { return this->radius; }
+        inline unsigned getSeed (void) const { return this->seed; }
+
+        // Side of a tile, tiles starting at multiples of it along each axis
+        inline float_max_t getTileSize (void) const { return tile_cells * this->cell_size; }
+
+        // Tiles held, the ones queried and the ones only sampled around them
+        inline std::size_t getTileCount (void) const { return this->tiles.size(); }
+        inline std::size_t getMemory (void) const {
+            return this->memory + this->region.capacity() * sizeof(Cell) + this->written.capacity() * sizeof(std::size_t);
+        }
+
+        // A smaller budget takes effect on the next query
+        inline std::size_t getBudget (void) const { return this->budget; }
+        inline void setBudget (std::size_t _budget) { this->budget = _budget; }
+
+        // Also frees the region, allocated again by the next query
+        inline void clear (void) {
+            this->tiles.clear(), this->memory = 0;
+            std::vector<Cell>().swap(this->region);
+            std::vector<std::size_t>().swap(this->written);
+        }
+
+        // Appends the points in [min, max) along each axis, generating the tiles it overlaps
+        // that are missing, then evicting the furthest tiles when over the budget
+        void query (const Vec<SIZE> &min, const Vec<SIZE> &max, std::vector<Vec<SIZE>> &points) {
+            const Index first = this->tileOf(this->cellOf(min)), last = this->tileOf(this->cellOf(max));
+            const float_max_t *lower = min.data(), *upper = max.data();
+
+            Index at = first;
+            bool done = false;
+            for (unsigned i = 0; i < SIZE; ++i) {
+                done = done || first[i] > last[i];
+            }
+
+            while (!done) {
+                for (const Vec<SIZE> &point : this->generate(at).points) {
+                    const float_max_t *p = point.data();
+                    bool inside = true;
+                    for (unsigned i = 0; i < SIZE; ++i) {
+                        inside = inside && lower[i] <= p[i] && p[i] < upper[i];
+                    }
+                    if (inside) {
+                        points.push_back(point);
+                    }
+                }
+
+                unsigned axis = 0;
+                for (; axis < SIZE; ++axis) {
+                    if (++at[axis] <= last[axis]) {
+                        break;
+                    }
+                    at[axis] = first[axis];
+                }
+                done = axis == SIZE;
+            }
+
+            this->evict(first, last);
+        }
+
+        inline std::vector<Vec<SIZE>> query (const Vec<SIZE> &min, const Vec<SIZE> &max) {
+            std::vector<Vec<SIZE>> points;
+            this->query(min, max, points);
+            return points;
+        }
+    };
+
+    template <unsigned SIZE>
+    constexpr unsigned PoissonDiscStream<SIZE>::reach;
+
+    template <unsigned SIZE>
+    constexpr unsigned PoissonDiscStream<SIZE>::halo;
+
+    template <unsigned SIZE>
+    constexpr unsigned PoissonDiscStream<SIZE>::tile_cells;
+
+    template <unsigned SIZE>
+    constexpr unsigned PoissonDiscStream<SIZE>::region_cells;
+
+}
+
+
+#endif
@@ -27,7 +27,7 @@ namespace Geometry {
 // -------------------------------------
 
         static Quaternion difference (Vec<3> vec_1, Vec<3> vec_2) {
-            static Vec<3> axis;
+            Vec<3> axis;
             vec_1.normalize();
             vec_2.normalize();
             constexpr float_max_t border = 1.0 - EPSILON;
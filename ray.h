@@ -0,0 +1,63 @@
+#ifndef MODULE_GRAPHICS_GEOMETRY_RAY_H_
+#define MODULE_GRAPHICS_GEOMETRY_RAY_H_
+
+#include <array>
+#include <limits>
+#include "defaults.h"
+#include "vec.h"
+#include "line.h"
+
+namespace Geometry {
+
+    // A Line prepared for repeated intersection tests: the inverse direction and its
+    // signs are computed once, and hits are only reported inside [t_min, t_max].
+    class Ray {
+
+        Vec<3> point, direction, inv_direction;
+        std::array<unsigned char, 3> sign;
+        float_max_t t_min, t_max;
+
+        inline void calcInverse (void) {
+            for (unsigned i = 0; i < 3; ++i) {
+                this->inv_direction[i] = 1.0 / this->direction[i];
+                this->sign[i] = this->inv_direction[i] < 0.0;
+            }
+        }
+
+    public:
+
+        Ray (void) {}
+
+        Ray (
+            const Vec<3> &_point,
+            const Vec<3> &_direction,
+            float_max_t _t_min = -std::numeric_limits<float_max_t>::infinity(),
+            float_max_t _t_max = std::numeric_limits<float_max_t>::infinity()
+        ) : point(_point), direction(_direction.normalized()), t_min(_t_min), t_max(_t_max) { this->calcInverse(); }
+
+        Ray (
+            const Line &line,
+            float_max_t _t_min = -std::numeric_limits<float_max_t>::infinity(),
+            float_max_t _t_max = std::numeric_limits<float_max_t>::infinity()
+        ) : point(line.getPoint()), direction(line.getDirection()), t_min(_t_min), t_max(_t_max) { this->calcInverse(); }
+
+        inline const Vec<3> &getPoint (void) const { return this->point; }
+        inline const Vec<3> &getDirection (void) const { return this->direction; }
+        inline const Vec<3> &getInverseDirection (void) const { return this->inv_direction; }
+        inline const std::array<unsigned char, 3> &getSign (void) const { return this->sign; }
+        inline float_max_t getTMin (void) const { return this->t_min; }
+        inline float_max_t getTMax (void) const { return this->t_max; }
+
+        inline void setPoint (const Vec<3> &_point) { this->point = _point; }
+        inline void setDirection (const Vec<3> &_direction) { this->direction = _direction.normalized(), this->calcInverse(); }
+        inline void setInterval (float_max_t _t_min, float_max_t _t_max) { this->t_min = _t_min, this->t_max = _t_max; }
+
+        inline bool contains (float_max_t t) const { return this->t_min <= t && t <= this->t_max; }
+        inline bool overlaps (float_max_t from, float_max_t to) const { return from <= to && from <= this->t_max && this->t_min <= to; }
+
+        inline Vec<3> at (float_max_t param) const { return this->getPoint() + (this->getDirection() * param); }
+        inline Line toLine (void) const { return Line(this->getPoint(), this->getDirection()); }
+    };
+};
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef MODULE_GRAPHICS_GEOMETRY_RAY_PACKET_H_
+#define MODULE_GRAPHICS_GEOMETRY_RAY_PACKET_H_
+
+#include <array>
+#include <limits>
+#include <cmath>
+#include "defaults.h"
+#include "vec.h"
+#include "ray.h"
+#include "simd.h"
+#include "slab.h"
+
+namespace Geometry {
+
+    // WIDTH coherent rays stored lane by lane, so the packet kernels in
+    // Intersection::Packet run the same instruction over every ray at once.
+    template <unsigned WIDTH, typename TYPE = float_max_t>
+    class RayPacket {
+
+        static_assert(WIDTH == 4 || WIDTH == 8, "RayPacket width should be 4 or 8.");
+
+        alignas(16) std::array<std::array<TYPE, WIDTH>, 3> point, direction, inv_direction;
+        std::array<TYPE, WIDTH> t_min, t_max;
+
+    public:
+
+        static constexpr unsigned width = WIDTH;
+
+        RayPacket (void) {}
+
+        RayPacket (const std::array<Ray, WIDTH> &rays) {
+            for (unsigned lane = 0; lane < WIDTH; ++lane) {
+                this->set(lane, rays[lane]);
+            }
+        }
+
+        inline void set (unsigned lane, const Ray &ray) {
+            for (unsigned i = 0; i < 3; ++i) {
+                this->point[i][lane] = ray.getPoint()[i];
+                this->direction[i][lane] = ray.getDirection()[i];
+                this->inv_direction[i][lane] = ray.getInverseDirection()[i];
+            }
+            this->t_min[lane] = ray.getTMin();
+            this->t_max[lane] = ray.getTMax();
+        }
+
+        inline Ray get (unsigned lane) const {
+            return Ray(
+                { this->point[0][lane], this->point[1][lane], this->point[2][lane] },
+                { this->direction[0][lane], this->direction[1][lane], this->direction[2][lane] },
+                this->t_min[lane], this->t_max[lane]
+            );
+        }
+
+        inline const TYPE *getPoint (unsigned axis) const { return this->point[axis].data(); }
+        inline const TYPE *getDirection (unsigned axis) const { return this->direction[axis].data(); }
+        inline const TYPE *getInverseDirection (unsigned axis) const { return this->inv_direction[axis].data(); }
+        inline const TYPE *getTMin (void) const { return this->t_min.data(); }
+        inline const TYPE *getTMax (void) const { return this->t_max.data(); }
+    };
+
+    template <unsigned WIDTH, typename TYPE>
+    constexpr unsigned RayPacket<WIDTH, TYPE>::width;
+
+    namespace Intersection {
+
+        // Per lane versions of BoxHit and SphereHit, bit `lane` of mask is that lane's hit
+        template <unsigned WIDTH, typename TYPE = float_max_t>
+        struct BoxPacketHit {
+            std::array<TYPE, WIDTH> t_min, t_max;
+            std::array<unsigned char, WIDTH> axis_t_min, axis_t_max;
+            std::array<bool, WIDTH> is_t_min_box_min, is_t_max_box_min;
+            unsigned mask;
+
+            inline bool hit (unsigned lane) const { return (this->mask >> lane) & 1u; }
+            inline explicit operator bool (void) const { return this->mask != 0; }
+        };
+
+        template <unsigned WIDTH, typename TYPE = float_max_t>
+        struct SpherePacketHit {
+            std::array<TYPE, WIDTH> t_min, t_max;
+            unsigned mask;
+
+            inline bool hit (unsigned lane) const { return (this->mask >> lane) & 1u; }
+            inline explicit operator bool (void) const { return this->mask != 0; }
+        };
+
+        namespace Packet {
+
+            // Same slab test as Intersection::Line::Box (const Ray &, ...), one lane per ray, see slab.h
+            template <unsigned WIDTH, typename TYPE>
+            BoxPacketHit<WIDTH, TYPE> Box (
+                const RayPacket<WIDTH, TYPE> &packet,
+                const Vec<3, TYPE> &box_min,
+                const Vec<3, TYPE> &box_max
+            ) {
+                typedef Simd::Lanes<TYPE, WIDTH> Lanes;
+
+                const Lanes zero = Lanes::broadcast(static_cast<TYPE>(0));
+                Lanes
+                    mu_min = Lanes::broadcast(-std::numeric_limits<TYPE>::infinity()),
+                    mu_max = Lanes::broadcast(std::numeric_limits<TYPE>::infinity()),
+                    axis_min = zero, axis_max = zero,
+                    is_min_box_min = zero, is_max_box_min = zero;
+
+                for (unsigned i = 0; i < 3; ++i) {
+                    const Lanes
+                        point = Lanes::load(packet.getPoint(i)),
+                        inv_direction = Lanes::load(packet.getInverseDirection(i)),
+                        axis = Lanes::broadcast(static_cast<TYPE>(i)),
+                        inverse = inv_direction < zero,
+                        forward = inv_direction >= zero,
+                        t_lower = (Lanes::broadcast(box_min.data()[i]) - point) * inv_direction,
+                        t_upper = (Lanes::broadcast(box_max.data()[i]) - point) * inv_direction;
+
+                    Slab(
+                        Simd::select(inverse, t_upper, t_lower),
+                        Simd::select(inverse, t_lower, t_upper),
+                        axis, forward, inverse,
+                        mu_min, axis_min, is_min_box_min,
+                        mu_max, axis_max, is_max_box_min
+                    );
+                }
+
+                const Lanes hit = (mu_min <= mu_max) & (mu_min <= Lanes::load(packet.getTMax())) & (Lanes::load(packet.getTMin()) <= mu_max);
+
+                BoxPacketHit<WIDTH, TYPE> result;
+                std::array<TYPE, WIDTH> axis_t_min, axis_t_max;
+                const unsigned t_min_box_min = is_min_box_min.bits(), t_max_box_min = is_max_box_min.bits();
+
+                mu_min.store(result.t_min.data());
+                mu_max.store(result.t_max.data());
+                axis_min.store(axis_t_min.data());
+                axis_max.store(axis_t_max.data());
+
+                for (unsigned lane = 0; lane < WIDTH; ++lane) {
+                    result.axis_t_min[lane] = static_cast<unsigned char>(axis_t_min[lane]);
+                    result.axis_t_max[lane] = static_cast<unsigned char>(axis_t_max[lane]);
+                    result.is_t_min_box_min[lane] = (t_min_box_min >> lane) & 1u;
+                    result.is_t_max_box_min[lane] = (t_max_box_min >> lane) & 1u;
+                }
+                result.mask = hit.bits();
+
+                return result;
+            }
+
+            // Same as Intersection::Line::Sphere, one lane per ray, restricted to each ray's interval
+            template <unsigned WIDTH, typename TYPE>
+            SpherePacketHit<WIDTH, TYPE> Sphere (
+                const RayPacket<WIDTH, TYPE> &packet,
+                const Vec<3, TYPE> &sphere_center,
+                const TYPE &sphere_radius
+            ) {
+                typedef Simd::Lanes<TYPE, WIDTH> Lanes;
+
+                const Lanes zero = Lanes::broadcast(static_cast<TYPE>(0));
+                Lanes b = zero, c = Lanes::broadcast(-sphere_radius * sphere_radius);
+
+                for (unsigned i = 0; i < 3; ++i) {
+                    const Lanes diff = Lanes::load(packet.getPoint(i)) - Lanes::broadcast(sphere_center.data()[i]);
+                    b = b + diff * Lanes::load(packet.getDirection(i));
+                    c = c + diff * diff;
+                }
+
+                const Lanes
+                    discr = b * b - c,
+                    sqrt_discr = sqrt(max(discr, zero)),
+                    mu_1 = zero - (b + sqrt_discr),
+                    mu_2 = sqrt_discr - b,
+                    hit = (discr >= zero) & (mu_1 <= Lanes::load(packet.getTMax())) & (Lanes::load(packet.getTMin()) <= mu_2);
+
+                SpherePacketHit<WIDTH, TYPE> result;
+                mu_1.store(result.t_min.data());
+                mu_2.store(result.t_max.data());
+                result.mask = hit.bits();
+
+                return result;
+            }
+        };
+    };
+};
+
+#endif
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include "renderer.h"
+#include "convex_polyhedron.h"
+#include "cylinder.h"
+#include "mesh.h"
+
+namespace Geometry {
+
+    Renderer::Renderer (const BVH &_bvh, const Camera &_camera, unsigned _tile_size) : bvh(_bvh), tile_size(_tile_size) {
+        this->setCamera(_camera);
+    }
+
+    // Lambert with the light at the eye, on a color per shape. Misses get a sky going up from the horizon.
+    void Renderer::shade (const Camera::Tile &tile, const VecArray<3> &directions) {
+        static const float_max_t colors[5][3] = {
+            { 0.90, 0.30, 0.25 },
+            { 0.25, 0.55, 0.90 },
+            { 0.95, 0.75, 0.20 },
+            { 0.40, 0.80, 0.40 },
+            { 0.75, 0.75, 0.75 }
+        };
+
+        const unsigned width = this->camera.getWidth();
+        const Vec<3> &position = this->camera.getPosition();
+
+        for (unsigned y = 0; y < tile.height; ++y) {
+            for (unsigned x = 0; x < tile.width; ++x) {
+                const Vec<3> direction = directions.get(static_cast<std::size_t>(y) * tile.width + x);
+                const Ray ray(position, direction);
+                const BVH::Hit hit = this->bvh.closest(ray);
+
+                float_max_t color[3];
+                if (hit) {
+                    const float_max_t
+                        *base = colors[static_cast<unsigned>(hit.shape)],
+                        light = 0.15 + 0.85 * std::abs(this->bvh.getNormal(ray, hit).dot(direction));
+                    for (unsigned i = 0; i < 3; ++i) {
+                        color[i] = base[i] * light;
+                    }
+                } else {
+                    const float_max_t sky = 0.5 + 0.5 * clamp<float_max_t>(direction[1], -1.0, 1.0);
+                    color[0] = 0.6 * sky, color[1] = 0.7 * sky, color[2] = sky;
+                }
+
+                unsigned char *pixel = this->image.data() + 3 * (static_cast<std::size_t>(tile.y + y) * width + tile.x + x);
+                for (unsigned i = 0; i < 3; ++i) {
+                    pixel[i] = static_cast<unsigned char>(255.0 * clamp<float_max_t>(color[i], 0.0, 1.0) + 0.5);
+                }
+            }
+        }
+    }
+
+// -----------------------------------------------------------------------------
+
+    Renderer::Stats Renderer::render (unsigned threads) {
+        ThreadPool pool(threads);
+        return this->render(pool);
+    }
+
+    Renderer::Stats Renderer::render (ThreadPool &pool) {
+        const auto start = std::chrono::steady_clock::now();
+        this->camera.forEachTile(
+            this->tile_size,
+            [ this ] (const Camera::Tile &tile, const VecArray<3> &directions) { this->shade(tile, directions); },
+            pool
+        );
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        Stats result;
+        result.threads = pool.size();
+        result.rays = static_cast<std::size_t>(this->camera.getWidth()) * this->camera.getHeight();
+        result.time = elapsed.count();
+        return result;
+    }
+
+    std::vector<Renderer::Stats> Renderer::benchmark (const std::vector<unsigned> &threads, unsigned runs) {
+        std::vector<Stats> result;
+        for (unsigned count : threads) {
+            ThreadPool pool(count);
+            this->render(pool);
+
+            Stats total = { pool.size(), 0, 0.0 };
+            for (unsigned run = 0; run < runs; ++run) {
+                const Stats stats = this->render(pool);
+                total.rays += stats.rays, total.time += stats.time;
+            }
+            result.push_back(total);
+        }
+        return result;
+    }
+
+    void Renderer::writePPM (const std::string &path) const {
+        std::ofstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("can't open " + path);
+        }
+        file << "P6\n" << this->camera.getWidth() << " " << this->camera.getHeight() << "\n255\n";
+        file.write(reinterpret_cast<const char *>(this->image.data()), this->image.size());
+        if (!file) {
+            throw std::runtime_error("can't write " + path);
+        }
+    }
+
+// -----------------------------------------------------------------------------
+
+    // Cells 3 units wide, shapes about a unit in radius resting on the floor, sizes varying by cell
+    void Renderer::benchmarkScene (BVH &bvh, unsigned count) {
+        constexpr float_max_t spacing = 3.0;
+        const float_max_t side = count * spacing;
+
+        bvh.clear();
+
+        const Mesh floor({ { -spacing, 0.0, -spacing }, { side, 0.0, -spacing }, { side, 0.0, side }, { -spacing, 0.0, side } }, { 0, 2, 1, 0, 3, 2 });
+        bvh.addMesh(floor);
+
+        for (unsigned i = 0; i < count; ++i) {
+            for (unsigned j = 0; j < count; ++j) {
+                const float_max_t radius = 0.6 + 0.3 * std::sin(1.7 * i + 2.3 * j);
+                const Vec<3> center = { i * spacing, radius, j * spacing };
+
+                switch ((i + 2 * j) % 5) {
+                    case 0:
+                        bvh.addSphere(center, radius);
+                        break;
+                    case 1:
+                        bvh.addBox(center - Vec<3>{ radius, radius, radius }, center + Vec<3>{ radius, radius, radius });
+                        break;
+                    case 2:
+                        bvh.addCylinder(Cylinder({ center[0], 0.0, center[2] }, Vec<3>::axisY, 3.0 * radius, 0.6 * radius));
+                        break;
+                    case 3: {
+                        // Octahedron, |x| + |y| + |z| <= radius around the center
+                        constexpr float_max_t one = 1.0;
+                        ConvexPolyhedron octahedron;
+                        for (unsigned corner = 0; corner < 8; ++corner) {
+                            const Vec<3> normal = Vec<3>{
+                                corner & 1u ? one : -one,
+                                corner & 2u ? one : -one,
+                                corner & 4u ? one : -one
+                            }.normalized();
+                            octahedron.addFace(normal, normal.dot(center) + radius / std::sqrt(3.0));
+                        }
+                        bvh.addPolyhedron(octahedron);
+                        break;
+                    }
+                    case 4:
+                        bvh.addTriangle(
+                            { center[0] - radius, 0.0, center[2] },
+                            { center[0] + radius, 0.0, center[2] },
+                            { center[0], radius + radius, center[2] }
+                        );
+                        break;
+                }
+            }
+        }
+
+        bvh.build();
+    }
+
+    // From above a corner of the grid, looking at its middle
+    Camera Renderer::benchmarkCamera (unsigned width, unsigned height, unsigned count) {
+        constexpr float_max_t spacing = 3.0;
+        const float_max_t side = count * spacing, corner = -0.25 * side, above = 0.35 * side, middle = 0.5 * side;
+        return Camera({ corner, above, corner }, { middle, 0.0, middle }, Vec<3>::axisY, DEG60, width, height);
+    }
+};
@@ -0,0 +1,71 @@
+#ifndef MODULE_GRAPHICS_GEOMETRY_RENDERER_H_
+#define MODULE_GRAPHICS_GEOMETRY_RENDERER_H_
+
+#include <string>
+#include <vector>
+#include "defaults.h"
+#include "vec.h"
+#include "camera.h"
+#include "bvh.h"
+#include "thread_pool.h"
+
+namespace Geometry {
+
+    // Headless ray caster: one primary ray per pixel through BVH::closest, shaded from the
+    // hit normal (BVH::getNormal) with a light at the camera, the image split in tiles taken
+    // by the threads as they get free. Rendering is timed, so it doubles as a throughput benchmark.
+    class Renderer {
+
+    public:
+
+        struct Stats {
+            unsigned threads;
+            std::size_t rays;
+            double time;
+
+            inline double getMraysPerSecond (void) const { return this->rays / this->time * 1e-6; }
+        };
+
+    private:
+
+        const BVH &bvh;
+        Camera camera;
+        unsigned tile_size;
+
+        // RGB, row after row
+        std::vector<unsigned char> image;
+
+        void shade (const Camera::Tile &tile, const VecArray<3> &directions);
+
+    public:
+
+        // The BVH should be built, and outlive the renderer
+        Renderer (const BVH &_bvh, const Camera &_camera, unsigned _tile_size = 16);
+
+        inline const Camera &getCamera (void) const { return this->camera; }
+        inline void setCamera (const Camera &_camera) { this->camera = _camera, this->image.assign(3 * this->camera.getWidth() * this->camera.getHeight(), 0); }
+
+        inline unsigned getTileSize (void) const { return this->tile_size; }
+        inline void setTileSize (unsigned _tile_size) { this->tile_size = _tile_size; }
+
+        inline const std::vector<unsigned char> &getImage (void) const { return this->image; }
+
+        // 0 threads means one per hardware thread
+        Stats render (unsigned threads = 0);
+        Stats render (ThreadPool &pool);
+
+        // A pool per thread count, each rendering runs times after a first untimed one, which
+        // warms the caches. Each result reports the total rays and time of the timed renders.
+        std::vector<Stats> benchmark (const std::vector<unsigned> &threads, unsigned runs = 3);
+
+        // Binary PPM (P6), throws std::runtime_error when the file can't be written
+        void writePPM (const std::string &path) const;
+
+        // Deterministic mix of every shape over a triangle mesh floor, count primitives per side
+        // of a grid, and a camera looking over it. The BVH is cleared and built.
+        static void benchmarkScene (BVH &bvh, unsigned count = 16);
+        static Camera benchmarkCamera (unsigned width, unsigned height, unsigned count = 16);
+    };
+};
+
+#endif
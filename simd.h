@@ -0,0 +1,190 @@
+#ifndef MODULE_GRAPHICS_GEOMETRY_SIMD_H_
+#define MODULE_GRAPHICS_GEOMETRY_SIMD_H_
+
+#include <algorithm>
+#include <cmath>
+#include "defaults.h"
+#include "vec_simd.h"
+
+namespace Geometry {
+
+    namespace Simd {
+
+        // WIDTH values of TYPE processed together. Widths the target can hold in one
+        // register map to SSE/AVX, wider ones are split in halves down to a scalar lane.
+        // Comparisons return masks, which are only meant for &, |, select and bits.
+        template <typename TYPE, unsigned WIDTH>
+        struct Lanes {
+
+            static_assert(WIDTH > 1 && (WIDTH & (WIDTH - 1)) == 0, "Lanes width should be a power of two.");
+
+            typedef Lanes<TYPE, WIDTH / 2> Half;
+
+            Half low, high;
+
+            static inline Lanes<TYPE, WIDTH> load (const TYPE *values) { return { Half::load(values), Half::load(values + WIDTH / 2) }; }
+            static inline Lanes<TYPE, WIDTH> broadcast (TYPE value) { return { Half::broadcast(value), Half::broadcast(value) }; }
+
+            inline void store (TYPE *values) const { this->low.store(values), this->high.store(values + WIDTH / 2); }
+
+            // One bit per lane of a mask, lane 0 in the lowest bit
+            inline unsigned bits (void) const { return this->low.bits() | (this->high.bits() << (WIDTH / 2)); }
+        };
+
+        template <typename TYPE>
+        struct Lanes<TYPE, 1> {
+
+            TYPE value;
+
+            static inline Lanes<TYPE, 1> load (const TYPE *values) { return { *values }; }
+            static inline Lanes<TYPE, 1> broadcast (TYPE value) { return { value }; }
+
+            inline void store (TYPE *values) const { *values = this->value; }
+
+            inline unsigned bits (void) const { return this->value != static_cast<TYPE>(0); }
+        };
+
+        // Lanes wide enough to fill an AVX register, used by the batched kernels
+        template <typename TYPE>
+        constexpr unsigned batchWidth (void) { return 32 / sizeof(TYPE); }
+
+        // Plain values go through the same select as Lanes, so kernels can be written once for both
+        template <typename TYPE>
+        inline TYPE select (bool mask, const TYPE &a, const TYPE &b) { return mask ? a : b; }
+
+// -----------------------------------------------------------------------------
+
+#define MODULE_GRAPHICS_GEOMETRY_SIMD_SPLIT_BINARY(OPERATOR) \
+        template <typename TYPE, unsigned WIDTH> \
+        inline Lanes<TYPE, WIDTH> OPERATOR (const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) { \
+            return { OPERATOR(a.low, b.low), OPERATOR(a.high, b.high) }; \
+        }
+
+        MODULE_GRAPHICS_GEOMETRY_SIMD_SPLIT_BINARY(operator +)
+        MODULE_GRAPHICS_GEOMETRY_SIMD_SPLIT_BINARY(operator -)
+        MODULE_GRAPHICS_GEOMETRY_SIMD_SPLIT_BINARY(operator *)
+        MODULE_GRAPHICS_GEOMETRY_SIMD_SPLIT_BINARY(operator /)
+        MODULE_GRAPHICS_GEOMETRY_SIMD_SPLIT_BINARY(operator <)
+        MODULE_GRAPHICS_GEOMETRY_SIMD_SPLIT_BINARY(operator >)
+        MODULE_GRAPHICS_GEOMETRY_SIMD_SPLIT_BINARY(operator <=)
+        MODULE_GRAPHICS_GEOMETRY_SIMD_SPLIT_BINARY(operator >=)
+        MODULE_GRAPHICS_GEOMETRY_SIMD_SPLIT_BINARY(operator &)
+        MODULE_GRAPHICS_GEOMETRY_SIMD_SPLIT_BINARY(operator |)
+        MODULE_GRAPHICS_GEOMETRY_SIMD_SPLIT_BINARY(min)
+        MODULE_GRAPHICS_GEOMETRY_SIMD_SPLIT_BINARY(max)
+
+#undef MODULE_GRAPHICS_GEOMETRY_SIMD_SPLIT_BINARY
+
+        template <typename TYPE, unsigned WIDTH>
+        inline Lanes<TYPE, WIDTH> sqrt (const Lanes<TYPE, WIDTH> &a) { return { sqrt(a.low), sqrt(a.high) }; }
+
+        // mask ? a : b, lane by lane
+        template <typename TYPE, unsigned WIDTH>
+        inline Lanes<TYPE, WIDTH> select (const Lanes<TYPE, WIDTH> &mask, const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) {
+            return { select(mask.low, a.low, b.low), select(mask.high, a.high, b.high) };
+        }
+
+// -------------------------------------
+
+        // Scalar lane: masks are 0 or 1. min and max keep the SSE rule of returning b when either is NaN.
+        template <typename TYPE> inline Lanes<TYPE, 1> operator + (const Lanes<TYPE, 1> &a, const Lanes<TYPE, 1> &b) { return { a.value + b.value }; }
+        template <typename TYPE> inline Lanes<TYPE, 1> operator - (const Lanes<TYPE, 1> &a, const Lanes<TYPE, 1> &b) { return { a.value - b.value }; }
+        template <typename TYPE> inline Lanes<TYPE, 1> operator * (const Lanes<TYPE, 1> &a, const Lanes<TYPE, 1> &b) { return { a.value * b.value }; }
+        template <typename TYPE> inline Lanes<TYPE, 1> operator / (const Lanes<TYPE, 1> &a, const Lanes<TYPE, 1> &b) { return { a.value / b.value }; }
+        template <typename TYPE> inline Lanes<TYPE, 1> operator < (const Lanes<TYPE, 1> &a, const Lanes<TYPE, 1> &b) { return { static_cast<TYPE>(a.value < b.value) }; }
+        template <typename TYPE> inline Lanes<TYPE, 1> operator > (const Lanes<TYPE, 1> &a, const Lanes<TYPE, 1> &b) { return { static_cast<TYPE>(a.value > b.value) }; }
+        template <typename TYPE> inline Lanes<TYPE, 1> operator <= (const Lanes<TYPE, 1> &a, const Lanes<TYPE, 1> &b) { return { static_cast<TYPE>(a.value <= b.value) }; }
+        template <typename TYPE> inline Lanes<TYPE, 1> operator >= (const Lanes<TYPE, 1> &a, const Lanes<TYPE, 1> &b) { return { static_cast<TYPE>(a.value >= b.value) }; }
+        template <typename TYPE> inline Lanes<TYPE, 1> operator & (const Lanes<TYPE, 1> &a, const Lanes<TYPE, 1> &b) { return { static_cast<TYPE>(a.value != 0 && b.value != 0) }; }
+        template <typename TYPE> inline Lanes<TYPE, 1> operator | (const Lanes<TYPE, 1> &a, const Lanes<TYPE, 1> &b) { return { static_cast<TYPE>(a.value != 0 || b.value != 0) }; }
+        template <typename TYPE> inline Lanes<TYPE, 1> min (const Lanes<TYPE, 1> &a, const Lanes<TYPE, 1> &b) { return { a.value < b.value ? a.value : b.value }; }
+        template <typename TYPE> inline Lanes<TYPE, 1> max (const Lanes<TYPE, 1> &a, const Lanes<TYPE, 1> &b) { return { a.value > b.value ? a.value : b.value }; }
+        template <typename TYPE> inline Lanes<TYPE, 1> sqrt (const Lanes<TYPE, 1> &a) { return { std::sqrt(a.value) }; }
+        template <typename TYPE> inline Lanes<TYPE, 1> select (const Lanes<TYPE, 1> &mask, const Lanes<TYPE, 1> &a, const Lanes<TYPE, 1> &b) { return mask.value != 0 ? a : b; }
+
+        // Smallest and largest lane, without going through memory
+        template <typename TYPE, unsigned WIDTH>
+        inline TYPE horizontalMin (const Lanes<TYPE, WIDTH> &a) { return std::min(horizontalMin(a.low), horizontalMin(a.high)); }
+        template <typename TYPE, unsigned WIDTH>
+        inline TYPE horizontalMax (const Lanes<TYPE, WIDTH> &a) { return std::max(horizontalMax(a.low), horizontalMax(a.high)); }
+        template <typename TYPE> inline TYPE horizontalMin (const Lanes<TYPE, 1> &a) { return a.value; }
+        template <typename TYPE> inline TYPE horizontalMax (const Lanes<TYPE, 1> &a) { return a.value; }
+
+// -----------------------------------------------------------------------------
+
+#ifdef MODULE_GRAPHICS_GEOMETRY_VEC_SIMD
+
+#define MODULE_GRAPHICS_GEOMETRY_SIMD_REGISTER(TYPE, WIDTH, REGISTER, PREFIX, SUFFIX) \
+        template <> \
+        struct Lanes<TYPE, WIDTH> { \
+            REGISTER value; \
+            static inline Lanes<TYPE, WIDTH> load (const TYPE *values) { return { PREFIX##_loadu_##SUFFIX(values) }; } \
+            static inline Lanes<TYPE, WIDTH> broadcast (TYPE value) { return { PREFIX##_set1_##SUFFIX(value) }; } \
+            inline void store (TYPE *values) const { PREFIX##_storeu_##SUFFIX(values, this->value); } \
+            inline unsigned bits (void) const { return static_cast<unsigned>(PREFIX##_movemask_##SUFFIX(this->value)); } \
+        }; \
+        \
+        inline Lanes<TYPE, WIDTH> operator + (const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) { return { PREFIX##_add_##SUFFIX(a.value, b.value) }; } \
+        inline Lanes<TYPE, WIDTH> operator - (const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) { return { PREFIX##_sub_##SUFFIX(a.value, b.value) }; } \
+        inline Lanes<TYPE, WIDTH> operator * (const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) { return { PREFIX##_mul_##SUFFIX(a.value, b.value) }; } \
+        inline Lanes<TYPE, WIDTH> operator / (const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) { return { PREFIX##_div_##SUFFIX(a.value, b.value) }; } \
+        inline Lanes<TYPE, WIDTH> operator & (const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) { return { PREFIX##_and_##SUFFIX(a.value, b.value) }; } \
+        inline Lanes<TYPE, WIDTH> operator | (const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) { return { PREFIX##_or_##SUFFIX(a.value, b.value) }; } \
+        inline Lanes<TYPE, WIDTH> min (const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) { return { PREFIX##_min_##SUFFIX(a.value, b.value) }; } \
+        inline Lanes<TYPE, WIDTH> max (const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) { return { PREFIX##_max_##SUFFIX(a.value, b.value) }; } \
+        inline Lanes<TYPE, WIDTH> sqrt (const Lanes<TYPE, WIDTH> &a) { return { PREFIX##_sqrt_##SUFFIX(a.value) }; } \
+        inline Lanes<TYPE, WIDTH> select (const Lanes<TYPE, WIDTH> &mask, const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) { \
+            return { PREFIX##_or_##SUFFIX(PREFIX##_and_##SUFFIX(mask.value, a.value), PREFIX##_andnot_##SUFFIX(mask.value, b.value)) }; \
+        }
+
+#define MODULE_GRAPHICS_GEOMETRY_SIMD_SSE_COMPARE(TYPE, WIDTH, SUFFIX) \
+        inline Lanes<TYPE, WIDTH> operator < (const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) { return { _mm_cmplt_##SUFFIX(a.value, b.value) }; } \
+        inline Lanes<TYPE, WIDTH> operator > (const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) { return { _mm_cmpgt_##SUFFIX(a.value, b.value) }; } \
+        inline Lanes<TYPE, WIDTH> operator <= (const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) { return { _mm_cmple_##SUFFIX(a.value, b.value) }; } \
+        inline Lanes<TYPE, WIDTH> operator >= (const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) { return { _mm_cmpge_##SUFFIX(a.value, b.value) }; }
+
+#define MODULE_GRAPHICS_GEOMETRY_SIMD_AVX_COMPARE(TYPE, WIDTH, SUFFIX) \
+        inline Lanes<TYPE, WIDTH> operator < (const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) { return { _mm256_cmp_##SUFFIX(a.value, b.value, _CMP_LT_OQ) }; } \
+        inline Lanes<TYPE, WIDTH> operator > (const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) { return { _mm256_cmp_##SUFFIX(a.value, b.value, _CMP_GT_OQ) }; } \
+        inline Lanes<TYPE, WIDTH> operator <= (const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) { return { _mm256_cmp_##SUFFIX(a.value, b.value, _CMP_LE_OQ) }; } \
+        inline Lanes<TYPE, WIDTH> operator >= (const Lanes<TYPE, WIDTH> &a, const Lanes<TYPE, WIDTH> &b) { return { _mm256_cmp_##SUFFIX(a.value, b.value, _CMP_GE_OQ) }; }
+
+        MODULE_GRAPHICS_GEOMETRY_SIMD_REGISTER(float, 4, __m128, _mm, ps)
+        MODULE_GRAPHICS_GEOMETRY_SIMD_SSE_COMPARE(float, 4, ps)
+        MODULE_GRAPHICS_GEOMETRY_SIMD_REGISTER(double, 2, __m128d, _mm, pd)
+        MODULE_GRAPHICS_GEOMETRY_SIMD_SSE_COMPARE(double, 2, pd)
+
+#ifdef __AVX__
+        MODULE_GRAPHICS_GEOMETRY_SIMD_REGISTER(float, 8, __m256, _mm256, ps)
+        MODULE_GRAPHICS_GEOMETRY_SIMD_AVX_COMPARE(float, 8, ps)
+        MODULE_GRAPHICS_GEOMETRY_SIMD_REGISTER(double, 4, __m256d, _mm256, pd)
+        MODULE_GRAPHICS_GEOMETRY_SIMD_AVX_COMPARE(double, 4, pd)
+#endif
+
+#define MODULE_GRAPHICS_GEOMETRY_SIMD_HORIZONTAL(NAME, OPERATION) \
+        inline float NAME (const Lanes<float, 4> &a) { \
+            const __m128 half = _mm_##OPERATION##_ps(a.value, _mm_movehl_ps(a.value, a.value)); \
+            return _mm_cvtss_f32(_mm_##OPERATION##_ss(half, _mm_shuffle_ps(half, half, 1))); \
+        } \
+        inline double NAME (const Lanes<double, 2> &a) { return _mm_cvtsd_f64(_mm_##OPERATION##_sd(a.value, _mm_unpackhi_pd(a.value, a.value))); }
+
+        MODULE_GRAPHICS_GEOMETRY_SIMD_HORIZONTAL(horizontalMin, min)
+        MODULE_GRAPHICS_GEOMETRY_SIMD_HORIZONTAL(horizontalMax, max)
+
+#ifdef __AVX__
+        inline float horizontalMin (const Lanes<float, 8> &a) { return horizontalMin(Lanes<float, 4>{ _mm_min_ps(_mm256_castps256_ps128(a.value), _mm256_extractf128_ps(a.value, 1)) }); }
+        inline float horizontalMax (const Lanes<float, 8> &a) { return horizontalMax(Lanes<float, 4>{ _mm_max_ps(_mm256_castps256_ps128(a.value), _mm256_extractf128_ps(a.value, 1)) }); }
+        inline double horizontalMin (const Lanes<double, 4> &a) { return horizontalMin(Lanes<double, 2>{ _mm_min_pd(_mm256_castpd256_pd128(a.value), _mm256_extractf128_pd(a.value, 1)) }); }
+        inline double horizontalMax (const Lanes<double, 4> &a) { return horizontalMax(Lanes<double, 2>{ _mm_max_pd(_mm256_castpd256_pd128(a.value), _mm256_extractf128_pd(a.value, 1)) }); }
+#endif
+
+#undef MODULE_GRAPHICS_GEOMETRY_SIMD_REGISTER
+#undef MODULE_GRAPHICS_GEOMETRY_SIMD_SSE_COMPARE
+#undef MODULE_GRAPHICS_GEOMETRY_SIMD_AVX_COMPARE
+#undef MODULE_GRAPHICS_GEOMETRY_SIMD_HORIZONTAL
+
+#endif
+    };
+};
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef MODULE_GRAPHICS_GEOMETRY_SLAB_H_
+#define MODULE_GRAPHICS_GEOMETRY_SLAB_H_
+
+#include "defaults.h"
+#include "simd.h"
+
+namespace Geometry {
+
+    namespace Intersection {
+
+        // One axis of the slab test behind Line::Box (const Ray &, ...), Packet::Box and Batch::Box.
+        // VALUE is float_max_t (masks are bool) or Simd::Lanes (masks are Lanes too). t_near and t_far
+        // are the distances to the bounds already picked by the sign of the direction, and a NaN
+        // (ray lying on the slab boundary) fails both comparisons, so that axis is ignored.
+        template <typename VALUE>
+        inline void Slab (
+            const VALUE &t_near,
+            const VALUE &t_far,
+            VALUE &mu_min,
+            VALUE &mu_max
+        ) {
+            mu_min = Simd::select(t_near > mu_min, t_near, mu_min);
+            mu_max = Simd::select(t_far < mu_max, t_far, mu_max);
+        }
+
+        // Same as above, also tracking which axis and which bound (box_min or box_max) gave each distance
+        template <typename VALUE, typename MASK, typename AXIS>
+        inline void Slab (
+            const VALUE &t_near,
+            const VALUE &t_far,
+            const AXIS &axis,
+            const MASK &is_near_box_min,
+            const MASK &is_far_box_min,
+            VALUE &mu_min,
+            AXIS &axis_t_min,
+            MASK &is_t_min_box_min,
+            VALUE &mu_max,
+            AXIS &axis_t_max,
+            MASK &is_t_max_box_min
+        ) {
+            const MASK
+                closer = t_near > mu_min,
+                farther = t_far < mu_max;
+
+            mu_min = Simd::select(closer, t_near, mu_min);
+            axis_t_min = Simd::select(closer, axis, axis_t_min);
+            is_t_min_box_min = Simd::select(closer, is_near_box_min, is_t_min_box_min);
+
+            mu_max = Simd::select(farther, t_far, mu_max);
+            axis_t_max = Simd::select(farther, axis, axis_t_max);
+            is_t_max_box_min = Simd::select(farther, is_far_box_min, is_t_max_box_min);
+        }
+    };
+};
+
+#endif
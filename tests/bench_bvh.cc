@@ -0,0 +1,36 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+#include "geometry.h"
+#include "check.h"
+
+using namespace Geometry;
+
+// Build time of 100k spheres by thread count, best of runs, with the tree each build gave
+int main (void) {
+    constexpr unsigned count = 100000, runs = 5;
+
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float_max_t> position(-100.0, 100.0), radius(0.1, 1.0);
+    BVH bvh;
+    for (unsigned i = 0; i < count; ++i) {
+        bvh.addSphere({ position(generator), position(generator), position(generator) }, radius(generator));
+    }
+
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("%u spheres, %u hardware threads\n", count, hardware);
+
+    double single = 0.0;
+    for (unsigned threads : { 1u, 2u, 4u, hardware }) {
+        ThreadPool pool(threads);
+        BVH::BuildStats stats = {};
+        const double elapsed = bestTime(runs, [ & ] () { stats = bvh.build(pool); });
+        single = single != 0.0 ? single : elapsed;
+        std::printf("  %3u threads  %7.1f ms  (%.2fx)   %u nodes, %u leaves, depth %u, SAH cost %.1f\n",
+            threads, elapsed * 1e3, single / elapsed, stats.node_count, stats.leaf_count, stats.max_depth, static_cast<double>(stats.sah_cost));
+    }
+
+    return 0;
+}
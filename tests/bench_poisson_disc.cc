@@ -0,0 +1,203 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+#include "geometry.h"
+#include "check.h"
+
+using namespace Geometry;
+
+// Heap in use and its peak, every allocation of the program going through here
+static std::atomic<std::size_t> heap(0), heap_peak(0);
+
+// Keeps the size ahead of the block, as far as the strictest alignment. Never inlined, where the
+// compiler would see the pointers given out and freed differ and warn.
+static constexpr std::size_t header = alignof(std::max_align_t);
+
+__attribute__((noinline)) void *operator new (std::size_t size) {
+    char *block = static_cast<char *>(std::malloc(size + header));
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<std::size_t *>(block) = size;
+    const std::size_t now = heap += size;
+    std::size_t peak = heap_peak;
+    while (now > peak && !heap_peak.compare_exchange_weak(peak, now));
+    return block + header;
+}
+
+__attribute__((noinline)) void operator delete (void *pointer) noexcept {
+    if (pointer != nullptr) {
+        char *block = static_cast<char *>(pointer) - header;
+        heap -= *reinterpret_cast<std::size_t *>(block);
+        std::free(block);
+    }
+}
+
+void operator delete (void *pointer, std::size_t) noexcept {
+    operator delete(pointer);
+}
+
+// PoissonDisc as it was before the flat grid: point indices in a grid of rows, the points kept
+// apart, and a single generator, seeded here so every run samples the same
+class BaselinePoissonDisc {
+
+    std::mt19937 random_generator;
+
+    const float_max_t radius, two_radius, radius2, width, height, cell_size, inv_cell_size;
+    const unsigned samples, grid_width, grid_height;
+    std::vector<Vec<2>> points;
+    std::vector<int> queue;
+    std::vector<std::vector<int>> grid;
+
+    void randomSinCos (float_max_t &random_sin, float_max_t &random_cos) {
+        std::bernoulli_distribution sin_signal(0.5);
+        std::uniform_real_distribution<float_max_t> cos_generator(-1.0, 1.0);
+
+        random_cos = cos_generator(this->random_generator);
+        random_sin = std::sqrt(1.0 - (random_cos * random_cos));
+        if (sin_signal(this->random_generator)) {
+            random_sin = -random_sin;
+        }
+    }
+
+    bool validPoint (const Vec<2> &point) const {
+        if (!(0.0 <= point[0] && point[0] < this->width && 0.0 <= point[1] && point[1] < this->height)) {
+            return false;
+        }
+
+        const unsigned
+            pos_x = point[0] * this->inv_cell_size,
+            pos_y = point[1] * this->inv_cell_size,
+            min_x = pos_x > 2 ? (pos_x - 2) : 0,
+            min_y = pos_y > 2 ? (pos_y - 2) : 0,
+            max_x = std::min(pos_x + 3, this->grid_width),
+            max_y = std::min(pos_y + 3, this->grid_height);
+
+        for (unsigned y = min_y; y < max_y; ++y) {
+            const std::vector<int> &line = this->grid[y];
+            for (unsigned x = min_x; x < max_x; ++x) {
+                if (line[x] >= 0 && point.distance2(this->points[line[x]]) < this->radius2) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void addPoint (const Vec<2> &point) {
+        const int position = this->points.size();
+        this->points.push_back(point);
+        this->queue.push_back(position);
+        this->grid[static_cast<unsigned>(point[1] * inv_cell_size)][static_cast<unsigned>(point[0] * inv_cell_size)] = position;
+    }
+
+public:
+
+    BaselinePoissonDisc (float_max_t _radius, float_max_t _width, float_max_t _height, unsigned _samples, unsigned seed) :
+        random_generator(seed),
+        radius(_radius), two_radius(_radius + _radius), radius2(_radius * _radius),
+        width(_width), height(_height),
+        cell_size(_radius * SQRT_2_INV), inv_cell_size(1.0 / cell_size),
+        samples(_samples),
+        grid_width(std::ceil(_width * inv_cell_size)), grid_height(std::ceil(_height * inv_cell_size)),
+        grid(grid_height, std::vector<int>(grid_width, -1))
+    {}
+
+    bool operator() (Vec<2> &next_point) {
+        if (this->points.empty()) {
+            std::uniform_real_distribution<float_max_t> position_x(0.0, this->width), position_y(0.0, this->height);
+            next_point = { position_x(this->random_generator), position_y(this->random_generator) };
+            this->addPoint(next_point);
+            return true;
+        }
+
+        std::vector<int>::reverse_iterator next;
+        for (auto it = this->queue.rbegin(); it != this->queue.rend(); it = next) {
+            std::uniform_real_distribution<float_max_t> generate_radius(this->radius, this->two_radius);
+            const Vec<2> close = this->points[*it];
+
+            for (unsigned i = 0; i < this->samples; ++i) {
+                const float_max_t radius = generate_radius(this->random_generator);
+                float_max_t angle_cos, angle_sin;
+                this->randomSinCos(angle_sin, angle_cos);
+
+                const Vec<2> point = { close[0] + angle_cos * radius, close[1] + angle_sin * radius };
+                if (this->validPoint(point)) {
+                    next_point = point;
+                    this->addPoint(point);
+                    return true;
+                }
+            }
+
+            next = std::next(it);
+            std::swap(*it, this->queue.back());
+            this->queue.pop_back();
+        }
+        return false;
+    }
+
+    const std::vector<Vec<2>> &allPoints (void) {
+        Vec<2> point;
+        while ((*this)(point));
+        return this->points;
+    }
+};
+
+// Samples of the best of runs and the heap they peaked at over what was in use before them
+template <typename FUNCTION>
+void report (const char *name, unsigned runs, const FUNCTION &function) {
+    const std::size_t before = heap;
+    heap_peak.store(before);
+    std::size_t count = 0;
+    const double elapsed = bestTime(runs, [ & ] () { count = function(); });
+    std::printf("  %-22s %9zu samples  %6.2f M samples/s  %7.1f MB peak\n",
+        name, count, count / elapsed * 1e-6, (heap_peak - before) / (1024.0 * 1024.0));
+}
+
+// Serial and tile-parallel over the unit box of SIZE dimensions
+template <unsigned SIZE>
+void dimension (float_max_t radius, unsigned samples, unsigned seed, unsigned runs, ThreadPool &pool) {
+    char serial[32], parallel[32];
+    std::snprintf(serial, sizeof(serial), "PoissonDisc<%u>", SIZE);
+    std::snprintf(parallel, sizeof(parallel), "PoissonDisc<%u> pool", SIZE);
+
+    std::printf("Unit box of %u dimensions, radius %g\n", SIZE, static_cast<double>(radius));
+    report(serial, runs, [ & ] () {
+        PoissonDisc<SIZE> disc(radius, Vec<SIZE>(1.0), samples, seed);
+        return disc.allPoints().size();
+    });
+    report(parallel, runs, [ & ] () {
+        PoissonDisc<SIZE> disc(radius, Vec<SIZE>(1.0), samples, seed);
+        return disc.allPoints(pool).size();
+    });
+}
+
+int main (void) {
+    constexpr float_max_t radius = 0.0005;
+    constexpr unsigned samples = 10, seed = 1, runs = 3;
+    ThreadPool pool;
+
+    std::printf("Unit square, radius %g\n", static_cast<double>(radius));
+    report("baseline", runs, [ & ] () {
+        BaselinePoissonDisc disc(radius, 1.0, 1.0, samples, seed);
+        return disc.allPoints().size();
+    });
+    report("PoissonDisc<2>", runs, [ & ] () {
+        PoissonDisc<2> disc(radius, 1.0, 1.0, samples, seed);
+        return disc.allPoints().size();
+    });
+    report("PoissonDisc<2> pool", runs, [ & ] () {
+        PoissonDisc<2> disc(radius, 1.0, 1.0, samples, seed);
+        return disc.allPoints(pool).size();
+    });
+
+    // About the same number of samples in every dimension
+    dimension<2>(0.004, samples, seed, runs, pool);
+    dimension<3>(0.02, samples, seed, runs, pool);
+    dimension<4>(0.07, samples, seed, runs, pool);
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <cstdio>
+#include <vector>
+#include "geometry.h"
+#include "ray_packet.h"
+#include "check.h"
+
+using namespace Geometry;
+
+// Coherent camera rays against a box and a sphere, one Ray at a time through Intersection::Line
+// and WIDTH at a time through Intersection::Packet, both counting the same hits
+template <unsigned WIDTH>
+unsigned benchmark (const std::vector<Ray> &rays, unsigned runs) {
+    const Vec<3> box_min = { -1.0, -1.0, -1.0 }, box_max = { 1.0, 1.0, 1.0 }, center = Vec<3>::origin;
+    const float_max_t radius = 1.0;
+    const unsigned count = rays.size();
+
+    std::vector<RayPacket<WIDTH>> packets(count / WIDTH);
+    for (unsigned i = 0; i < count; ++i) {
+        packets[i / WIDTH].set(i % WIDTH, rays[i]);
+    }
+
+    unsigned scalar_hits = 0, packet_hits = 0;
+    const double scalar_box = bestTime(runs, [ & ] () {
+        scalar_hits = 0;
+        for (const Ray &ray : rays) {
+            scalar_hits += Intersection::Line::Box(ray, box_min, box_max).hit;
+        }
+    });
+    const double packet_box = bestTime(runs, [ & ] () {
+        packet_hits = 0;
+        for (const RayPacket<WIDTH> &packet : packets) {
+            packet_hits += __builtin_popcount(Intersection::Packet::Box(packet, box_min, box_max).mask);
+        }
+    });
+    unsigned failures = scalar_hits != packet_hits;
+
+    const double scalar_sphere = bestTime(runs, [ & ] () {
+        scalar_hits = 0;
+        for (const Ray &ray : rays) {
+            const Intersection::SphereHit hit = Intersection::Line::Sphere(ray.getPoint(), ray.getDirection(), center, radius);
+            scalar_hits += hit && ray.overlaps(hit.t_min, hit.t_max);
+        }
+    });
+    const double packet_sphere = bestTime(runs, [ & ] () {
+        packet_hits = 0;
+        for (const RayPacket<WIDTH> &packet : packets) {
+            packet_hits += __builtin_popcount(Intersection::Packet::Sphere(packet, center, radius).mask);
+        }
+    });
+    failures += scalar_hits != packet_hits;
+
+    std::printf("  width %u   box    scalar %6.2f ns   packet %6.2f ns  (%.1fx)\n",
+        WIDTH, scalar_box / count * 1e9, packet_box / count * 1e9, scalar_box / packet_box);
+    std::printf("  width %u   sphere scalar %6.2f ns   packet %6.2f ns  (%.1fx)\n",
+        WIDTH, scalar_sphere / count * 1e9, packet_sphere / count * 1e9, scalar_sphere / packet_sphere);
+
+    return failures;
+}
+
+int main (void) {
+    constexpr unsigned side = 512, runs = 20;
+
+    const Camera camera({ 0.0, 0.0, 4.0 }, Vec<3>::origin, Vec<3>::axisY, DEG90 / 2.0, side, side);
+    std::vector<Ray> rays;
+    rays.reserve(side * side);
+    for (unsigned y = 0; y < side; ++y) {
+        for (unsigned x = 0; x < side; ++x) {
+            rays.push_back(camera.getRay(x, y));
+        }
+    }
+
+    std::printf("%u camera rays, per ray\n", side * side);
+    return benchmark<4>(rays, runs) + benchmark<8>(rays, runs);
+}
@@ -0,0 +1,32 @@
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "geometry.h"
+#include "renderer.h"
+
+using namespace Geometry;
+
+// Primary rays per second of the benchmark scene by thread count, the image written as a PPM
+// to the path given, build/renderer.ppm by default
+int main (int argc, char **argv) {
+    constexpr unsigned width = 640, height = 480;
+    const char *path = argc > 1 ? argv[1] : "build/renderer.ppm";
+
+    BVH bvh;
+    Renderer::benchmarkScene(bvh);
+    Renderer renderer(bvh, Renderer::benchmarkCamera(width, height));
+
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("%u primitives, %u x %u rays, %u hardware threads\n", bvh.size(), width, height, hardware);
+
+    const std::vector<Renderer::Stats> results = renderer.benchmark({ 1, 2, 4, hardware });
+    for (const Renderer::Stats &stats : results) {
+        std::printf("  %3u threads  %7.2f Mrays/s  (%.2fx)\n",
+            stats.threads, stats.getMraysPerSecond(), stats.getMraysPerSecond() / results.front().getMraysPerSecond());
+    }
+
+    renderer.writePPM(path);
+    std::printf("Wrote %s\n", path);
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include <cstdio>
+#include <vector>
+#include "vec.h"
+#include "check.h"
+
+using namespace Geometry;
+
+// a + b * 1.5 - c over many Vec<3>, fused by the expression templates and one
+// operator at a time through mapped(), the path every operator took before them
+int main (void) {
+    constexpr unsigned count = 1 << 16, runs = 20;
+
+    std::vector<Vec<3>> a(count), b(count), c(count), result(count);
+    for (unsigned i = 0; i < count; ++i) {
+        a[i] = Vec<3>::random(), b[i] = Vec<3>::random(), c[i] = Vec<3>::random();
+    }
+
+    const double fused = bestTime(runs, [ & ] () {
+        for (unsigned i = 0; i < count; ++i) {
+            result[i] = a[i] + b[i] * 1.5 - c[i];
+        }
+    });
+    float_max_t fused_sum = 0.0;
+    for (const Vec<3> &vec : result) {
+        fused_sum += vec.sum();
+    }
+
+    const double mapped = bestTime(runs, [ & ] () {
+        for (unsigned i = 0; i < count; ++i) {
+            const Vec<3> scaled = b[i].mapped([] (const float_max_t &value) { return value * 1.5; });
+            const Vec<3> added = a[i].mapped([] (const float_max_t &x, const float_max_t &y) { return x + y; }, scaled.begin(), scaled.end());
+            result[i] = added.mapped([] (const float_max_t &x, const float_max_t &y) { return x - y; }, c[i].begin(), c[i].end());
+        }
+    });
+    float_max_t mapped_sum = 0.0;
+    for (const Vec<3> &vec : result) {
+        mapped_sum += vec.sum();
+    }
+
+    std::printf("a + b * 1.5 - c, Vec<3>, %u vectors\n", count);
+    std::printf("  expression  %8.2f ns\n", fused / count * 1e9);
+    std::printf("  mapped()    %8.2f ns  (%.1fx)\n", mapped / count * 1e9, mapped / fused);
+
+    return std::abs(fused_sum - mapped_sum) > 1e-3 * std::abs(fused_sum);
+}
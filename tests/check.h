@@ -0,0 +1,35 @@
+#ifndef MODULE_GRAPHICS_GEOMETRY_TESTS_CHECK_H_
+#define MODULE_GRAPHICS_GEOMETRY_TESTS_CHECK_H_
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include "defaults.h"
+
+// Every failed check is reported, the test returning the number of failures
+static unsigned check_failures __attribute__((unused)) = 0;
+
+#define CHECK(CONDITION) \
+    do { \
+        if (!(CONDITION)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " << #CONDITION << std::endl; \
+            ++check_failures; \
+        } \
+    } while (false)
+
+#define CHECK_CLOSE(A, B) CHECK(std::abs((A) - (B)) <= 100 * Geometry::EPSILON * (1 + std::abs(B)))
+
+// Best of runs, in seconds, of function()
+template <typename FUNCTION>
+double bestTime (unsigned runs, const FUNCTION &function) {
+    double best = 1e300;
+    for (unsigned run = 0; run < runs; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+#endif
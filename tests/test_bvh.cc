@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "geometry.h"
+#include "check.h"
+
+using namespace Geometry;
+
+static std::mt19937 generator(1);
+
+static float_max_t uniform (float_max_t min, float_max_t max) {
+    return std::uniform_real_distribution<float_max_t>(min, max)(generator);
+}
+
+static Vec<3> uniform (const Vec<3> &min, const Vec<3> &max) {
+    return { uniform(min[0], max[0]), uniform(min[1], max[1]), uniform(min[2], max[2]) };
+}
+
+static Vec<3> direction (void) {
+    const float_max_t z = uniform(-1.0, 1.0), angle = uniform(0.0, 2.0 * PI), r = std::sqrt(1.0 - z * z);
+    return { r * std::cos(angle), r * std::sin(angle), z };
+}
+
+// Octahedron of the given size around the center, tilted by a random rotation
+static ConvexPolyhedron octahedron (const Vec<3> &center, float_max_t size) {
+    constexpr float_max_t one = 1.0;
+    const Quaternion rotation = Quaternion::axisAngle(direction(), uniform(0.0, PI));
+    ConvexPolyhedron result;
+    for (unsigned corner = 0; corner < 8; ++corner) {
+        const Vec<3> normal = rotation.rotated(Vec<3>{ corner & 1u ? one : -one, corner & 2u ? one : -one, corner & 4u ? one : -one }.normalized());
+        result.addFace(normal, normal.dot(center) + size);
+    }
+    return result;
+}
+
+// Every shape in turn, scattered in a cube of the given side around the origin
+static void scatter (BVH &bvh, unsigned count, float_max_t side) {
+    const Vec<3> min(-0.5 * side), max(0.5 * side);
+    for (unsigned i = 0; i < count; ++i) {
+        const Vec<3> center = uniform(min, max);
+        const float_max_t size = uniform(0.1, 0.5);
+        switch (i % 5) {
+            case 0:
+                bvh.addSphere(center, size);
+                break;
+            case 1:
+                bvh.addBox(center - uniform(Vec<3>(0.05), Vec<3>(size)), center + uniform(Vec<3>(0.05), Vec<3>(size)));
+                break;
+            case 2:
+                bvh.addCylinder(Cylinder(center, direction(), 2.0 * size, 0.5 * size));
+                break;
+            case 3:
+                bvh.addPolyhedron(octahedron(center, size));
+                break;
+            case 4:
+                bvh.addTriangle(center + direction() * size, center + direction() * size, center + direction() * size);
+                break;
+        }
+    }
+}
+
+// Rays from outside the cube through it, starting at their origin
+static std::vector<Ray> rays (unsigned count, float_max_t side) {
+    std::vector<Ray> result;
+    for (unsigned i = 0; i < count; ++i) {
+        const Vec<3> from = direction() * side, to = uniform(Vec<3>(-0.5 * side), Vec<3>(0.5 * side));
+        result.emplace_back(from, to - from, 0.0);
+    }
+    return result;
+}
+
+// closest, any and all through the tree against intersect over every primitive, returning the hits
+static unsigned agree (const BVH &bvh, const std::vector<Ray> &probes) {
+    unsigned hits = 0;
+    for (const Ray &ray : probes) {
+        BVH::Hit nearest = {};
+        std::vector<unsigned> crossed;
+        for (unsigned primitive = 0; primitive < bvh.size(); ++primitive) {
+            const BVH::Hit hit = bvh.intersect(primitive, ray);
+            if (hit) {
+                crossed.push_back(primitive);
+                if (!nearest || hit.t < nearest.t) {
+                    nearest = hit;
+                }
+            }
+        }
+
+        const BVH::Hit closest = bvh.closest(ray);
+        CHECK(static_cast<bool>(closest) == static_cast<bool>(nearest));
+        CHECK(bvh.any(ray) == static_cast<bool>(nearest));
+        if (closest && nearest) {
+            ++hits;
+            CHECK(closest.t == nearest.t);
+            CHECK(bvh.intersect(closest.primitive, ray).t == nearest.t);
+
+            const Vec<3> normal = bvh.getNormal(ray, closest);
+            CHECK_CLOSE(normal.length(), 1.0);
+            CHECK(normal.dot(ray.getDirection()) <= EPSILON);
+        }
+
+        std::vector<BVH::Hit> all;
+        CHECK(bvh.all(ray, all) == crossed.size());
+        CHECK(std::is_sorted(all.begin(), all.end(), [] (const BVH::Hit &a, const BVH::Hit &b) { return a.t < b.t; }));
+        std::vector<unsigned> found;
+        for (const BVH::Hit &hit : all) {
+            found.push_back(hit.primitive);
+        }
+        std::sort(found.begin(), found.end());
+        CHECK(found == crossed);
+    }
+    return hits;
+}
+
+// Small moves keep the tree about as good as built, scattering every primitive across the
+// cube leaves it correct but loose enough to ask for a rebuild
+static void refit (BVH &bvh, const std::vector<Ray> &probes, float_max_t side, ThreadPool &pool) {
+    unsigned moved = 0;
+    for (unsigned primitive = 0; primitive < bvh.size(); primitive += 3, ++moved) {
+        const Quaternion rotation = Quaternion::axisAngle(direction(), uniform(0.0, 0.2));
+        bvh.move(primitive, rotation, direction() * 0.1, bvh.getBounds(primitive).getCenter());
+    }
+    bvh.setSphere(0, { 1.0, 2.0, 3.0 }, 0.25);
+
+    BVH::RefitStats nudged = bvh.refit(pool);
+    CHECK(nudged.moved_count == moved && nudged.node_count > 0);
+    CHECK(nudged.degradation < 1.2 && !nudged.needs_rebuild);
+    agree(bvh, probes);
+
+    for (unsigned primitive = 0; primitive < bvh.size(); ++primitive) {
+        const Vec<3> to = uniform(Vec<3>(-0.5 * side), Vec<3>(0.5 * side));
+        bvh.move(primitive, Quaternion::identity, to - bvh.getBounds(primitive).getCenter());
+    }
+    const BVH::RefitStats scattered = bvh.refit(pool);
+    CHECK(scattered.moved_count == bvh.size());
+    CHECK(scattered.degradation > 1.5 && scattered.needs_rebuild);
+    agree(bvh, probes);
+
+    bvh.build(pool);
+    const BVH::RefitStats rebuilt = bvh.refit(pool);
+    CHECK(rebuilt.moved_count == 0 && rebuilt.degradation == 1.0 && !rebuilt.needs_rebuild);
+}
+
+int main (void) {
+    constexpr float_max_t side = 20.0;
+    ThreadPool pool(4);
+
+    // Over the parallel threshold, so subtrees get built by different tasks
+    BVH bvh;
+    scatter(bvh, 10000, side);
+    const BVH::BuildStats stats = bvh.build(pool);
+    CHECK(stats.leaf_count > 0 && stats.max_depth <= BVH::max_depth + 32);
+    const std::vector<Ray> probes = rays(1000, side);
+    CHECK(agree(bvh, probes) > probes.size() / 4);
+
+    refit(bvh, probes, side, pool);
+
+    // A few primitives, a single leaf and an empty tree
+    BVH small, empty;
+    scatter(small, 5, side);
+    small.build(pool);
+    agree(small, probes);
+    empty.build(pool);
+    CHECK(!empty.closest(probes[0]) && !empty.any(probes[0]));
+
+    return check_failures;
+}
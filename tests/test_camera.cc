@@ -0,0 +1,129 @@
+#include <atomic>
+#include <vector>
+#include "geometry.h"
+#include "check.h"
+
+using namespace Geometry;
+
+// A box or sphere of the given half size, and whether culling must keep it
+struct Case {
+    Vec<3> center;
+    float_max_t size;
+    bool kept;
+};
+
+// Inside the frustum, wholly past each of its six faces, and straddling each of them
+static std::vector<Case> cases (const Camera &camera, float_max_t near, float_max_t far) {
+    const Vec<3> &eye = camera.getPosition(), &forward = camera.getDirection(), &right = camera.getRight(), &up = camera.getUp();
+    const float_max_t
+        half_height = std::tan(camera.getFieldOfView() * 0.5),
+        half_width = half_height * camera.getWidth() / camera.getHeight(),
+        middle = 0.5 * (near + far);
+
+    const Vec<3> ahead = eye + forward * middle;
+    const Vec<3> edges[4] = { -right * (middle * half_width), right * (middle * half_width), up * (middle * half_height), -up * (middle * half_height) };
+
+    std::vector<Case> result = {
+        { ahead, 0.2, true },
+        { eye + forward * (0.5 * near), 0.1, false },
+        { eye + forward * (2.0 * far), 0.1, false },
+        { eye + forward * near, 0.2, true },
+        { eye + forward * far, 0.2, true }
+    };
+    for (const Vec<3> &edge : edges) {
+        result.push_back({ ahead + edge * 1.5, 0.2, false });
+        result.push_back({ ahead + edge, 0.2, true });
+    }
+    return result;
+}
+
+// Frustum faces in order, then Cull::Box and Cull::Sphere over the cases, repeated past 64
+static void cull (void) {
+    constexpr float_max_t near = 1.0, far = 10.0;
+    const Camera camera({ 1.0, 2.0, 3.0 }, { -2.0, 1.0, -4.0 }, Vec<3>::axisY, DEG60, 640, 480);
+    const ConvexPolyhedron frustum = camera.getFrustum(near, far);
+    CHECK(frustum.size() == 6);
+
+    const Vec<3> &eye = camera.getPosition(), &forward = camera.getDirection();
+    CHECK(frustum.contains(eye + forward * 5.0));
+    CHECK(!frustum.contains(eye + forward * 0.5) && !frustum.contains(eye + forward * 11.0));
+    CHECK(frustum.getNormal(0).dot(forward) < 0.0 && frustum.getNormal(1).dot(forward) > 0.0);
+    CHECK(frustum.getNormal(2).dot(camera.getRight()) < 0.0 && frustum.getNormal(3).dot(camera.getRight()) > 0.0);
+    CHECK(frustum.getNormal(4).dot(camera.getUp()) > 0.0 && frustum.getNormal(5).dot(camera.getUp()) < 0.0);
+
+    // The corner rays of the image lie on the side faces
+    const Vec<3> corner = camera.getRay(0.0, 0.0).at(5.0);
+    CHECK(std::abs(frustum.getNormal(2).dot(corner) - frustum.getD(2)) <= 1e3 * EPSILON);
+    CHECK(std::abs(frustum.getNormal(4).dot(corner) - frustum.getD(4)) <= 1e3 * EPSILON);
+
+    const std::vector<Case> base = cases(camera, near, far);
+    VecArray<3> box_min, box_max, center;
+    std::vector<float_max_t> radius;
+    std::vector<bool> kept;
+    for (unsigned i = 0; i < 70; ++i) {
+        const Case &item = base[i % base.size()];
+        box_min.push_back(item.center - Vec<3>(item.size)), box_max.push_back(item.center + Vec<3>(item.size));
+        center.push_back(item.center), radius.push_back(item.size);
+        kept.push_back(item.kept);
+    }
+
+    const std::vector<std::uint64_t>
+        boxes = Intersection::Cull::Box(frustum, box_min, box_max),
+        spheres = Intersection::Cull::Sphere(frustum, center, radius);
+    CHECK(boxes.size() == 2 && spheres.size() == 2);
+    for (unsigned i = 0; i < kept.size(); ++i) {
+        CHECK(((boxes[i / 64] >> (i % 64)) & 1u) == kept[i]);
+        CHECK(((spheres[i / 64] >> (i % 64)) & 1u) == kept[i]);
+    }
+    CHECK((boxes[1] >> (kept.size() - 64)) == 0 && (spheres[1] >> (kept.size() - 64)) == 0);
+}
+
+// getRays, forEachTile and getRay through the pixel centers agree pixel for pixel, tiles covering
+// every pixel once, on images and tiles whose sides don't divide each other nor the batch width
+static void rays (unsigned width, unsigned height, unsigned tile_size, ThreadPool &pool) {
+    const Camera camera({ 0.5, -1.0, 2.0 }, { 3.0, 0.0, -1.0 }, Vec<3>::axisZ, DEG60, width, height);
+    const std::size_t count = static_cast<std::size_t>(width) * height;
+
+    VecArray<3> directions;
+    camera.getRays(directions, pool);
+    CHECK(directions.size() == count);
+
+    VecArray<3> tiled(count);
+    std::vector<std::atomic<unsigned>> visits(count);
+    for (std::atomic<unsigned> &visit : visits) {
+        visit.store(0);
+    }
+    camera.forEachTile(tile_size, [ width, &tiled, &visits ] (const Camera::Tile &tile, const VecArray<3> &tile_directions) {
+        for (unsigned y = 0; y < tile.height; ++y) {
+            for (unsigned x = 0; x < tile.width; ++x) {
+                const std::size_t pixel = static_cast<std::size_t>(tile.y + y) * width + tile.x + x;
+                tiled.set(pixel, tile_directions.get(static_cast<std::size_t>(y) * tile.width + x));
+                ++visits[pixel];
+            }
+        }
+    }, pool);
+
+    for (unsigned y = 0; y < height; ++y) {
+        for (unsigned x = 0; x < width; ++x) {
+            const std::size_t pixel = static_cast<std::size_t>(y) * width + x;
+            const Ray ray = camera.getRay(x + 0.5, y + 0.5);
+            CHECK(visits[pixel] == 1);
+            CHECK(ray.getPoint() == camera.getPosition());
+            CHECK(directions.get(pixel).distance(ray.getDirection()) <= 10 * EPSILON);
+            CHECK(tiled.get(pixel).distance(ray.getDirection()) <= 10 * EPSILON);
+        }
+    }
+}
+
+int main (void) {
+    ThreadPool pool(3);
+
+    cull();
+
+    rays(37, 23, 7, pool);
+    rays(37, 23, 16, pool);
+    rays(64, 48, 1, pool);
+    rays(3, 5, 64, pool);
+
+    return check_failures;
+}
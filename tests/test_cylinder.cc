@@ -0,0 +1,70 @@
+#include <cmath>
+#include <random>
+#include "geometry.h"
+#include "check.h"
+
+using namespace Geometry;
+
+static std::mt19937 generator(1);
+
+static float_max_t uniform (float_max_t min, float_max_t max) {
+    return std::uniform_real_distribution<float_max_t>(min, max)(generator);
+}
+
+static Vec<3> point (float_max_t min, float_max_t max) {
+    return { uniform(min, max), uniform(min, max), uniform(min, max) };
+}
+
+// Off every axis, so the frame goes through the quaternion rather than the identity
+int main (void) {
+    const Vec<3> bottom{ 0.5, -1.0, 0.25 }, direction = Vec<3>{ 1.0, 2.0, -0.5 }.normalized();
+    const float_max_t height = 3.0, radius = 0.75;
+    const Cylinder cylinder(bottom, direction, height, radius);
+
+    CHECK(cylinder.getDelta().distance(direction * height) <= EPSILON);
+    CHECK_CLOSE(cylinder.getHeight2(), height * height);
+
+    // The parametrization of the side, the same as the raw one and back through at
+    for (unsigned i = 0; i < 200; ++i) {
+        const float_max_t u = uniform(-3.0, 3.0) * radius, v = uniform(0.1, height - 0.1);
+        const Vec<3> side = cylinder.at(u, v);
+        CHECK(cylinder.contains(side, 1e-4));
+        CHECK_CLOSE(side.distance(bottom + direction * direction.dot(side - bottom)), radius);
+
+        const Vec<2> param = cylinder.param(side), raw = Parametric::Cylinder(bottom, direction, height, radius, side);
+        CHECK_CLOSE(param[0], raw[0]);
+        CHECK_CLOSE(param[1], raw[1]);
+        CHECK_CLOSE(param[0], u);
+        CHECK_CLOSE(param[1], v);
+        CHECK(cylinder.at(param[0], param[1]).distance(side) <= 1e-4);
+    }
+
+    // Off the side v is 0 in both
+    const Vec<3> below = bottom - direction;
+    CHECK(cylinder.param(below)[1] == 0.0 && Parametric::Cylinder(bottom, direction, height, radius, below)[1] == 0.0);
+
+    // The overloads on the cylinder against the raw parameters, hits and misses
+    unsigned hits = 0;
+    for (unsigned i = 0; i < 500; ++i) {
+        const Vec<3> from = bottom + point(-1.0, 1.0).normalized() * 5.0;
+        const Vec<3> to = bottom + direction * uniform(-0.5, height + 0.5) + point(-1.0, 1.0) * radius;
+        const Vec<3> line_direction = to - from;
+
+        const Intersection::CylinderHit hit = Intersection::Line::Cylinder(from, line_direction, cylinder);
+        const Intersection::CylinderHit raw = Intersection::Line::Cylinder(from, line_direction, bottom, direction * height, height * height, radius);
+        CHECK(hit.hit == raw.hit);
+        if (hit && raw) {
+            CHECK_CLOSE(hit.t_min, raw.t_min);
+            CHECK_CLOSE(hit.t_max, raw.t_max);
+            CHECK(hit.is_t_min_top_cap == raw.is_t_min_top_cap && hit.is_t_min_bottom_cap == raw.is_t_min_bottom_cap);
+            CHECK(hit.is_t_max_top_cap == raw.is_t_max_top_cap && hit.is_t_max_bottom_cap == raw.is_t_max_bottom_cap);
+            ++hits;
+        }
+
+        const Ray ray(from, line_direction, 0.0, uniform(0.5, 1.5));
+        CHECK(Intersection::Any::Cylinder(ray, cylinder) == Intersection::Any::Cylinder(ray, bottom, direction * height, height * height, radius));
+    }
+    CHECK(hits > 100 && hits < 500);
+
+    return check_failures;
+}
@@ -0,0 +1,79 @@
+#include "geometry.h"
+#include "check.h"
+
+using namespace Geometry;
+using namespace Geometry::Intersection;
+
+// The Line queries still take the call shapes of the bool versions: no outputs, any prefix
+// of the outputs or all of them, the outputs being left as they were on a miss
+int main (void) {
+    const Vec<3>
+        point = { 0.0, 0.0, -5.0 },
+        direction = { 0.0, 0.0, 1.0 },
+        away = { 0.0, 5.0, -5.0 },
+        box_min = { -1.0, -1.0, -1.0 },
+        box_max = { 1.0, 1.0, 1.0 };
+
+    float_max_t t_min = -1.0, t_max = -1.0;
+    unsigned axis_t_min = 7, axis_t_max = 7, face_min = 7, face_max = 7;
+    bool is_min = false, is_max = false, top_cap = false, bottom_cap = false;
+
+    const bool sphere = Line::Sphere(point, direction, Vec<3>::origin, 1.0);
+    CHECK(sphere);
+    CHECK(Line::Sphere(point, direction, Vec<3>::origin, 1.0, t_min));
+    CHECK_CLOSE(t_min, 4.0);
+    CHECK(Line::Sphere(point, direction, Vec<3>::origin, 1.0, t_min, t_max));
+    CHECK_CLOSE(t_max, 6.0);
+
+    t_min = t_max = -1.0;
+    CHECK(!Line::Sphere(away, direction, Vec<3>::origin, 1.0, t_min, t_max));
+    CHECK(t_min == -1.0 && t_max == -1.0);
+
+    const bool box = Line::Box(point, direction, box_min, box_max);
+    CHECK(box);
+    CHECK(Line::Box(point, direction, box_min, box_max, t_min));
+    CHECK_CLOSE(t_min, 4.0);
+    CHECK(Line::Box(point, direction, box_min, box_max, t_min, axis_t_min, is_min));
+    CHECK(axis_t_min == 2 && is_min);
+    CHECK(Line::Box(point, direction, box_min, box_max, t_min, axis_t_min, is_min, t_max, axis_t_max, is_max));
+    CHECK_CLOSE(t_max, 6.0);
+    CHECK(axis_t_max == 2 && !is_max);
+
+    // Leaving through the minimum face the other way round
+    const Vec<3> back = { 0.0, 0.0, 5.0 };
+    CHECK(Line::Box(back, -direction, box_min, box_max, t_min, axis_t_min, is_min, t_max, axis_t_max, is_max));
+    CHECK(axis_t_min == 2 && !is_min && axis_t_max == 2 && is_max);
+
+    axis_t_min = 7;
+    CHECK(!Line::Box(away, direction, box_min, box_max, t_min, axis_t_min));
+    CHECK(axis_t_min == 7);
+
+    const Vec<3> bottom = { 0.0, 0.0, -1.0 }, delta = { 0.0, 0.0, 2.0 };
+    const bool cylinder = Line::Cylinder(point, direction, bottom, delta, delta.length2(), 1.0);
+    CHECK(cylinder);
+    CHECK(Line::Cylinder(point, direction, bottom, delta, delta.length2(), 1.0, t_min, top_cap));
+    CHECK_CLOSE(t_min, 4.0);
+    CHECK(top_cap);
+    CHECK(Line::Cylinder(point, direction, bottom, delta, delta.length2(), 1.0, t_min, top_cap, bottom_cap, t_max));
+    CHECK_CLOSE(t_max, 6.0);
+    CHECK(!bottom_cap);
+
+    const std::vector<Plane> planes = {
+        Plane(Vec<3>::axisX, box_max), Plane(-Vec<3>::axisX, box_min),
+        Plane(Vec<3>::axisY, box_max), Plane(-Vec<3>::axisY, box_min),
+        Plane(Vec<3>::axisZ, box_max), Plane(-Vec<3>::axisZ, box_min)
+    };
+    const bool polyhedron = Line::Polyhedron(point, direction, planes);
+    CHECK(polyhedron);
+    CHECK(Line::Polyhedron(point, direction, planes, t_min, face_min));
+    CHECK_CLOSE(t_min, 4.0);
+    CHECK(face_min == 5);
+    CHECK(Line::Polyhedron(point, direction, planes, t_min, face_min, t_max));
+    CHECK_CLOSE(t_max, 6.0);
+
+    face_min = face_max = 7;
+    CHECK(!Line::Polyhedron(away, direction, planes, t_min, face_min, t_max, face_max));
+    CHECK(face_min == 7 && face_max == 7);
+
+    return check_failures;
+}
@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "geometry.h"
+#include "check.h"
+
+using namespace Geometry;
+
+static std::mt19937 generator(1);
+
+static float_max_t uniform (float_max_t min, float_max_t max) {
+    return std::uniform_real_distribution<float_max_t>(min, max)(generator);
+}
+
+static Vec<3> point (float_max_t min, float_max_t max) {
+    return { uniform(min, max), uniform(min, max), uniform(min, max) };
+}
+
+// Counts around the groups and the 64 bit blocks, so the tail copies run on partial groups
+static std::vector<std::size_t> sizes (void) {
+    const std::size_t width = Simd::batchWidth<float_max_t>();
+    return { 1, std::max<std::size_t>(1, width - 1), 63, 64, 65, 130 };
+}
+
+// From outside the cube, some along an axis, some with a short interval
+static std::vector<Ray> rays (unsigned count) {
+    std::vector<Ray> result;
+    for (unsigned i = 0; i < count; ++i) {
+        Vec<3> from = point(-1.0, 1.0).normalized() * 3.0, direction = point(-1.0, 1.0) - from;
+        if (i % 8 == 7) {
+            direction = Vec<3>::zero;
+            direction[i % 3] = from[i % 3] > 0.0 ? -1.0 : 1.0;
+        }
+        result.emplace_back(from, direction, 0.0, i % 4 == 3 ? uniform(1.0, 3.0) : std::numeric_limits<float_max_t>::infinity());
+    }
+    return result;
+}
+
+// Batch::Box against Line::Box (const Ray &, ...) box by box
+static void box (const std::vector<Ray> &probes) {
+    std::size_t hits = 0;
+    for (std::size_t size : sizes()) {
+        VecArray<3> box_min, box_max;
+        for (std::size_t i = 0; i < size; ++i) {
+            const Vec<3> center = point(-1.0, 1.0), half = point(0.05, 0.4);
+            box_min.push_back(center - half), box_max.push_back(center + half);
+        }
+
+        for (const Ray &ray : probes) {
+            const Intersection::BoxBatchHit batch = Intersection::Batch::Box(ray, box_min, box_max);
+            CHECK(batch.mask.size() == (size + 63) / 64 && batch.t_min.size() == size);
+
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < size; ++i) {
+                const Intersection::BoxHit hit = Intersection::Line::Box(ray, box_min.get(i), box_max.get(i));
+                CHECK(batch.hit(i) == hit.hit);
+                if (hit) {
+                    ++count;
+                    CHECK_CLOSE(batch.t_min[i], hit.t_min);
+                }
+            }
+            CHECK(batch.count == count);
+            hits += count;
+            CHECK(static_cast<bool>(batch) == (count != 0));
+
+            // Nothing set past the last box
+            if (size % 64 != 0) {
+                CHECK((batch.mask.back() >> (size % 64)) == 0);
+            }
+        }
+    }
+    CHECK(hits > probes.size());
+}
+
+// Batch::Sphere against the nearest of Line::Sphere sphere by sphere, at the entry when it's in
+// the ray interval and at the exit otherwise. Some spheres are copies of earlier ones, across
+// groups and into the tail, and the copy must lose the tie.
+static void sphere (const std::vector<Ray> &probes) {
+    unsigned hits = 0, ties = 0;
+    for (std::size_t size : sizes()) {
+        std::vector<std::size_t> originals;
+        VecArray<3> center;
+        std::vector<float_max_t> radius;
+        for (std::size_t i = 0; i < size; ++i) {
+            if (i % 5 == 4) {
+                const std::size_t original = i - 4 + i % 3;
+                originals.push_back(original);
+                center.push_back(center.get(original)), radius.push_back(radius[original]);
+            } else {
+                center.push_back(point(-1.0, 1.0)), radius.push_back(uniform(0.05, 0.4));
+            }
+        }
+
+        for (const Ray &ray : probes) {
+            Intersection::SphereBatchHit nearest = { 0.0, 0, false };
+            for (std::size_t i = 0; i < size; ++i) {
+                const Intersection::SphereHit hit = Intersection::Line::Sphere(ray.getPoint(), ray.getDirection(), center.get(i), radius[i]);
+                if (!hit) {
+                    continue;
+                }
+                const float_max_t t = ray.contains(hit.t_min) ? hit.t_min : hit.t_max;
+                if (ray.contains(t) && (!nearest.hit || t < nearest.t)) {
+                    nearest = { t, i, true };
+                }
+            }
+
+            const Intersection::SphereBatchHit batch = Intersection::Batch::Sphere(ray, center, radius);
+            CHECK(batch.hit == nearest.hit);
+            if (batch && nearest) {
+                ++hits;
+                CHECK_CLOSE(batch.t, nearest.t);
+                CHECK(batch.sphere == nearest.sphere);
+                ties += std::count(originals.begin(), originals.end(), batch.sphere) != 0;
+            }
+        }
+    }
+    CHECK(hits > probes.size() && ties > 0);
+}
+
+// Batch::Plane against Line::Plane and Plane::param line by line, a line in four parallel to the
+// plane, the directions left unnormalized
+static void plane (void) {
+    const Geometry::Plane tilted(Vec<3>{ 0.3, -0.5, 0.8 }.normalized(), 0.4);
+    const Vec<3> along = tilted.getNormal().cross(Vec<3>::axisX);
+
+    unsigned hits = 0, parallel = 0;
+    for (std::size_t size : sizes()) {
+        VecArray<3> line_point, line_direction;
+        for (std::size_t i = 0; i < size; ++i) {
+            line_point.push_back(point(-2.0, 2.0));
+            line_direction.push_back(i % 4 == 1 ? along * uniform(0.5, 2.0) : point(-2.0, 2.0));
+        }
+
+        const Intersection::PlaneBatchHit batch = Intersection::Batch::Plane(line_point, line_direction, tilted, true);
+        const Intersection::PlaneBatchHit bare = Intersection::Batch::Plane(line_point, line_direction, tilted);
+        CHECK(batch.t.size() == size && batch.s_param.size() == size && batch.t_param.size() == size);
+        CHECK(bare.s_param.empty() && bare.t_param.empty() && bare.mask == batch.mask);
+
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < size; ++i) {
+            const Vec<3> from = line_point.get(i), direction = line_direction.get(i);
+            const Intersection::PlaneHit hit = Intersection::Line::Plane(from, direction, tilted);
+            CHECK(batch.hit(i) == hit.hit);
+            parallel += i % 4 == 1 && !batch.hit(i);
+            if (hit) {
+                ++count;
+                CHECK_CLOSE(batch.t[i], hit.t);
+                CHECK_CLOSE(bare.t[i], hit.t);
+                const Vec<2> param = tilted.param(from + direction * hit.t);
+                CHECK(std::abs(batch.s_param[i] - param[0]) <= 1e3 * EPSILON * (1.0 + std::abs(param[0])));
+                CHECK(std::abs(batch.t_param[i] - param[1]) <= 1e3 * EPSILON * (1.0 + std::abs(param[1])));
+            }
+        }
+        CHECK(batch.count == count && bare.count == count);
+        hits += count;
+        if (size % 64 != 0) {
+            CHECK((batch.mask.back() >> (size % 64)) == 0);
+        }
+    }
+    CHECK(hits > 0 && parallel > 0);
+}
+
+int main (void) {
+    const std::vector<Ray> probes = rays(400);
+
+    box(probes);
+    sphere(probes);
+    plane();
+
+    return check_failures;
+}
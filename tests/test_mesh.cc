@@ -0,0 +1,112 @@
+#include <random>
+#include <vector>
+#include "geometry.h"
+#include "check.h"
+
+using namespace Geometry;
+
+static std::mt19937 generator(1);
+
+static float_max_t uniform (float_max_t min, float_max_t max) {
+    return std::uniform_real_distribution<float_max_t>(min, max)(generator);
+}
+
+// Height field of side x side quads in [-1, 1]^2, and extra loose triangles above it
+static Mesh terrain (unsigned side, unsigned extra) {
+    std::vector<Vec<3>> vertices;
+    std::vector<unsigned> indices;
+    for (unsigned y = 0; y <= side; ++y) {
+        for (unsigned x = 0; x <= side; ++x) {
+            const float_max_t u = 2.0 * x / side - 1.0, v = 2.0 * y / side - 1.0, height = 0.2 * std::sin(3.0 * u) * std::cos(2.0 * v);
+            vertices.push_back({ u, v, height });
+        }
+    }
+    for (unsigned y = 0; y < side; ++y) {
+        for (unsigned x = 0; x < side; ++x) {
+            const unsigned corner = y * (side + 1) + x;
+            indices.insert(indices.end(), { corner, corner + 1, corner + side + 2, corner, corner + side + 2, corner + side + 1 });
+        }
+    }
+    for (unsigned i = 0; i < extra; ++i) {
+        const Vec<3> center = { uniform(-1.0, 1.0), uniform(-1.0, 1.0), uniform(0.3, 0.8) };
+        for (unsigned corner = 0; corner < 3; ++corner) {
+            indices.push_back(vertices.size());
+            vertices.push_back(center + Vec<3>{ uniform(-0.2, 0.2), uniform(-0.2, 0.2), uniform(-0.2, 0.2) });
+        }
+    }
+    return Mesh(vertices, indices);
+}
+
+// Down onto the mesh from above, some slanted past its sides, some with a short interval
+static std::vector<Ray> rays (unsigned count) {
+    std::vector<Ray> result;
+    for (unsigned i = 0; i < count; ++i) {
+        const Vec<3> from = { uniform(-1.5, 1.5), uniform(-1.5, 1.5), 2.0 }, to = { uniform(-1.5, 1.5), uniform(-1.5, 1.5), -1.0 };
+        result.emplace_back(from, to - from, 0.0, i % 4 == 3 ? uniform(0.5, 2.5) : std::numeric_limits<float_max_t>::infinity());
+    }
+    return result;
+}
+
+// closest and any against Line::Triangle on every triangle from its vertices
+static unsigned agree (const Mesh &mesh, const std::vector<Ray> &probes) {
+    unsigned hits = 0;
+    for (const Ray &ray : probes) {
+        Intersection::TriangleHit nearest = {};
+        for (unsigned triangle = 0; triangle < mesh.getTriangleCount(); ++triangle) {
+            const Intersection::TriangleHit hit = Intersection::Line::Triangle(ray, mesh.getVertex(triangle, 0), mesh.getVertex(triangle, 1), mesh.getVertex(triangle, 2));
+            if (hit && (!nearest || hit.t < nearest.t)) {
+                nearest = hit;
+            }
+        }
+
+        const Mesh::Hit closest = mesh.closest(ray);
+        CHECK(static_cast<bool>(closest) == static_cast<bool>(nearest));
+        CHECK(mesh.any(ray) == static_cast<bool>(nearest));
+        if (closest && nearest) {
+            ++hits;
+            CHECK_CLOSE(closest.t, nearest.t);
+            const Intersection::TriangleHit own = mesh.intersect(closest.triangle, ray);
+            CHECK(own);
+            CHECK_CLOSE(own.t, closest.t);
+            CHECK_CLOSE(closest.u, own.u);
+            CHECK_CLOSE(closest.v, own.v);
+            CHECK(mesh.getPoint(closest.triangle, closest.u, closest.v).distance(ray.at(closest.t)) <= 1e3 * EPSILON);
+        }
+    }
+    return hits;
+}
+
+int main (void) {
+    const std::vector<Ray> probes = rays(2000);
+
+    // 70 and 131 triangles: over 64, so several Batch::Triangle calls, and no multiple of the width
+    Mesh small = terrain(5, 20), large = terrain(8, 3);
+    CHECK(small.getTriangleCount() == 70 && large.getTriangleCount() == 131);
+    CHECK(agree(small, probes) > probes.size() / 2);
+    CHECK(agree(large, probes) > probes.size() / 2);
+
+    // Every triangle using a moved vertex follows it
+    for (unsigned vertex = 0; vertex < large.getVertexCount(); vertex += 7) {
+        large.setVertex(vertex, large.getVertex(vertex) + Vec<3>{ 0.0, 0.0, uniform(-0.3, 0.3) });
+    }
+    agree(large, probes);
+
+    // Tilted and shifted, the vertices going where Vec::transformed takes them
+    const Vec<3> axis = Vec<3>{ 1.0, 2.0, 0.5 }.normalized(), before = large.getVertex(3);
+    const float_max_t angle = 0.4, c = std::cos(angle), s = std::sin(angle), k = 1.0 - c;
+    const std::array<float_max_t, 16> matrix = {
+        c + axis[0] * axis[0] * k, axis[1] * axis[0] * k + axis[2] * s, axis[2] * axis[0] * k - axis[1] * s, 0.0,
+        axis[0] * axis[1] * k - axis[2] * s, c + axis[1] * axis[1] * k, axis[2] * axis[1] * k + axis[0] * s, 0.0,
+        axis[0] * axis[2] * k + axis[1] * s, axis[1] * axis[2] * k - axis[0] * s, c + axis[2] * axis[2] * k, 0.0,
+        0.1, -0.2, 0.05, 1.0
+    };
+    const Vec<3> pivot = { 0.2, 0.1, 0.0 };
+    large.transform(matrix, pivot);
+    CHECK(large.getVertex(3).distance(before.transformed(matrix, pivot)) <= 100 * EPSILON);
+    CHECK(agree(large, probes) > probes.size() / 4);
+
+    Mesh empty;
+    CHECK(!empty.closest(probes[0]) && !empty.any(probes[0]));
+
+    return check_failures;
+}
@@ -0,0 +1,45 @@
+#include <thread>
+#include <vector>
+#include "geometry.h"
+#include "check.h"
+
+using namespace Geometry;
+
+// Lazy planes parametrize on first read, the same as eager ones, from any number of threads
+int main (void) {
+    const Vec<3> normal = Vec<3>{ 1.0, 2.0, 3.0 }.normalized();
+    const Plane eager(normal, 2.0), lazy(normal, 2.0, Plane::Lazy());
+
+    const Plane copy = lazy;
+    CHECK(copy.getSIndex() == eager.getSIndex() && copy.getTIndex() == eager.getTIndex());
+    CHECK(copy.getPoint().distance(eager.getPoint()) <= EPSILON);
+
+    ConvexPolyhedron polyhedron;
+    for (unsigned face = 0; face < 64; ++face) {
+        polyhedron.addFace(Vec<3>::random(), 1.0);
+    }
+    const std::vector<Plane> planes = polyhedron.toPlanes();
+    std::vector<Plane> eager_planes;
+    for (unsigned face = 0; face < polyhedron.size(); ++face) {
+        eager_planes.emplace_back(polyhedron.getNormal(face), polyhedron.getD(face));
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<unsigned> failures(4, 0);
+    for (unsigned thread = 0; thread < failures.size(); ++thread) {
+        threads.emplace_back([&planes, &eager_planes, &failures, thread] () {
+            for (unsigned face = 0; face < planes.size(); ++face) {
+                const Vec<3> point = planes[face].at(0.5, -0.5);
+                failures[thread] += point != eager_planes[face].at(0.5, -0.5) || planes[face].getSIndex() != eager_planes[face].getSIndex();
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    for (unsigned thread_failures : failures) {
+        CHECK(thread_failures == 0);
+    }
+
+    return check_failures;
+}
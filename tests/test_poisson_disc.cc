@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+#include "geometry.h"
+#include "check.h"
+
+using namespace Geometry;
+
+// No two samples closer than the radius, whatever the rounding of the cell offsets. Samples are
+// bucketed in cells a radius wide, so each is only compared with the 3^SIZE cells around its own.
+template <unsigned SIZE>
+bool apart (const std::vector<Vec<SIZE>> &points, float_max_t radius) {
+    if (points.empty()) {
+        return true;
+    }
+
+    Vec<SIZE> min = points.front();
+    for (const Vec<SIZE> &point : points) {
+        for (unsigned i = 0; i < SIZE; ++i) {
+            min[i] = std::min(min[i], point[i]);
+        }
+    }
+    std::array<std::size_t, SIZE> cells;
+    std::array<std::size_t, SIZE> stride;
+    cells.fill(1);
+    for (const Vec<SIZE> &point : points) {
+        for (unsigned i = 0; i < SIZE; ++i) {
+            cells[i] = std::max(cells[i], static_cast<std::size_t>((point[i] - min[i]) / radius) + 1);
+        }
+    }
+    std::size_t total = 1;
+    for (unsigned i = 0; i < SIZE; ++i) {
+        stride[i] = total;
+        total *= cells[i];
+    }
+
+    // Counting sort of the samples by cell
+    const auto cellOf = [ &min, radius ] (const Vec<SIZE> &point, unsigned axis) {
+        return static_cast<std::size_t>((point[axis] - min[axis]) / radius);
+    };
+    std::vector<std::size_t> start(total + 1, 0), order(points.size());
+    for (const Vec<SIZE> &point : points) {
+        std::size_t cell = 0;
+        for (unsigned i = 0; i < SIZE; ++i) {
+            cell += cellOf(point, i) * stride[i];
+        }
+        ++start[cell + 1];
+    }
+    for (std::size_t cell = 0; cell < total; ++cell) {
+        start[cell + 1] += start[cell];
+    }
+    std::vector<std::size_t> next(start.begin(), start.end() - 1);
+    for (std::size_t index = 0; index < points.size(); ++index) {
+        std::size_t cell = 0;
+        for (unsigned i = 0; i < SIZE; ++i) {
+            cell += cellOf(points[index], i) * stride[i];
+        }
+        order[next[cell]++] = index;
+    }
+
+    std::size_t around = 1;
+    for (unsigned i = 0; i < SIZE; ++i) {
+        around *= 3;
+    }
+    for (std::size_t index = 0; index < points.size(); ++index) {
+        for (std::size_t offset = 0; offset < around; ++offset) {
+            std::size_t cell = 0, digits = offset;
+            bool inside = true;
+            for (unsigned i = 0; i < SIZE; ++i, digits /= 3) {
+                const std::size_t at = cellOf(points[index], i) + digits % 3;
+                inside = inside && at >= 1 && at <= cells[i];
+                cell += (at - 1) * stride[i];
+            }
+            for (std::size_t other = inside ? start[cell] : 0; inside && other < start[cell + 1]; ++other) {
+                if (order[other] != index && points[index].distance(points[order[other]]) < radius) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Serially over half the box, and in parallel with the given samples over the whole of it, at
+// least three tiles along every axis so each phase grows from what the phases before left in its halo
+template <unsigned SIZE>
+void check (float_max_t radius, unsigned samples, ThreadPool &pool) {
+    CHECK(std::ceil(std::sqrt(static_cast<float_max_t>(SIZE)) / radius) > 64);
+
+    PoissonDisc<SIZE> serial(radius, Vec<SIZE>(0.5), 10, 1);
+    CHECK(serial.allPoints().size() > 1);
+    CHECK(apart(serial.getPoints(), radius));
+
+    PoissonDisc<SIZE> parallel(radius, Vec<SIZE>(1.0), samples, 1), again(radius, Vec<SIZE>(1.0), samples, 1);
+    CHECK(parallel.allPoints(pool).size() > 1);
+    CHECK(apart(parallel.getPoints(), radius));
+    CHECK(again.allPoints(pool) == parallel.getPoints());
+}
+
+// With the same cells as PoissonDisc, from min to max along every axis
+template <unsigned SIZE>
+void checkStream (float_max_t radius, float_max_t min, float_max_t max) {
+    PoissonDiscStream<SIZE> stream(radius, 64u << 20, 10, 1);
+    const std::vector<Vec<SIZE>> streamed = stream.query(Vec<SIZE>(min), Vec<SIZE>(max));
+    CHECK(streamed.size() > 1);
+    CHECK(apart(streamed, radius));
+}
+
+int main (void) {
+    ThreadPool pool(4);
+
+    // Across the edge of a bucket as well
+    CHECK(!apart(std::vector<Vec<2>>{ { 0.0, 0.0 }, { 0.5, 0.5 }, { 0.51, 0.52 } }, 0.03));
+    CHECK(apart(std::vector<Vec<2>>{ { 0.0, 0.0 }, { 0.5, 0.5 }, { 0.52, 0.52 } }, 0.02));
+
+    // Fewer samples in 4D, where three tiles along each axis are already about 19 million cells
+    check<2>(0.02, 10, pool);
+    check<3>(0.025, 10, pool);
+    check<4>(0.0305, 3, pool);
+
+    // Across the tile corners around the origin
+    checkStream<2>(0.02, -0.5, 0.5);
+    checkStream<3>(0.1, -0.5, 0.5);
+
+    // A tile only needs the samples of the tiles around it, however high its phase
+    PoissonDiscStream<3> single(0.1, 64u << 20, 10, 1);
+    const float_max_t tile = single.getTileSize();
+    CHECK(!single.query(Vec<3>(tile), Vec<3>(1.5 * tile)).empty());
+    CHECK(single.getTileCount() == 27);
+
+    // The sides of the box need not be the same
+    PoissonDisc<2> wide(0.05, { 2.0, 0.5 }, 10, 3);
+    for (const Vec<2> &point : wide.allPoints(pool)) {
+        CHECK(point[0] >= 0.0 && point[0] < 2.0 && point[1] >= 0.0 && point[1] < 0.5);
+    }
+    CHECK(apart(wide.getPoints(), 0.05));
+
+    // Also given as width and height, the height being 1 by default as it always was
+    PoissonDisc<2> old_shape(0.05, 2.0, 0.5, 10, 3), strip(0.05, 2.0);
+    CHECK(old_shape.allPoints(pool) == wide.getPoints());
+    bool reaches_past_one = false;
+    for (const Vec<2> &point : strip.allPoints()) {
+        CHECK(point[0] >= 0.0 && point[0] < 2.0 && point[1] >= 0.0 && point[1] < 1.0);
+        reaches_past_one = reaches_past_one || point[0] >= 1.0;
+    }
+    CHECK(reaches_past_one);
+
+    // The region the tiles are generated in counts in the budget, and cells left from other
+    // tiles never show in the next
+    PoissonDiscStream<2> stream(0.02, 0, 10, 1), fresh(0.02, 0, 10, 1);
+    CHECK(stream.getMemory() == 0);
+    stream.query(Vec<2>(2.0), Vec<2>(2.5));
+    CHECK(stream.getMemory() >= 38 * 38 * 2 * sizeof(std::uint8_t));
+    CHECK(stream.query(Vec<2>(-0.5), Vec<2>(0.5)) == fresh.query(Vec<2>(-0.5), Vec<2>(0.5)));
+    stream.clear();
+    CHECK(stream.getMemory() == 0);
+
+    return check_failures;
+}
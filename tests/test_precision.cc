@@ -0,0 +1,43 @@
+#include <type_traits>
+#include "geometry.h"
+#include "check.h"
+
+using namespace Geometry;
+
+// Built twice by the Makefile, once per precision: the scalar type and its tolerance follow
+// MODULE_GRAPHICS_GEOMETRY_SINGLE_PRECISION, and the modules give the same answers in both
+int main (void) {
+#ifdef MODULE_GRAPHICS_GEOMETRY_SINGLE_PRECISION
+    CHECK((std::is_same<float_max_t, float>::value));
+#else
+    CHECK((std::is_same<float_max_t, double>::value));
+#endif
+    CHECK(EPSILON == epsilon<float_max_t>());
+    CHECK(float_max_t(1.0) + EPSILON != float_max_t(1.0));
+
+    const Vec<3> point = { 0.0, 0.0, -5.0 }, direction = { 0.0, 0.0, 1.0 };
+
+    const Intersection::SphereHit sphere = Intersection::Line::Sphere(point, direction, Vec<3>::origin, 1.0);
+    CHECK(sphere.hit);
+    CHECK_CLOSE(sphere.t_min, 4.0);
+    CHECK_CLOSE(sphere.t_max, 6.0);
+
+    const Intersection::BoxHit box = Intersection::Line::Box(Ray(point, direction), { -1.0, -1.0, -1.0 }, { 1.0, 1.0, 1.0 });
+    CHECK(box.hit);
+    CHECK_CLOSE(box.t_min, 4.0);
+    CHECK(box.axis_t_min == 2 && box.is_t_min_box_min);
+
+    const Intersection::PlaneHit plane = Intersection::Line::Plane(point, direction, Plane(Vec<3>::axisZ, Vec<3>{ 0.0, 0.0, 2.0 }));
+    CHECK(plane.hit);
+    CHECK_CLOSE(plane.t, 7.0);
+
+    const Vec<3> rotated = Quaternion::axisAngle(Vec<3>::axisZ, DEG90).rotated(Vec<3>::axisX);
+    CHECK_CLOSE(rotated[0], 0.0);
+    CHECK_CLOSE(rotated[1], 1.0);
+
+    const Quaternion difference = Quaternion::difference(Vec<3>::axisX, Vec<3>::axisY);
+    const Vec<3> turned = difference.rotated(Vec<3>::axisX);
+    CHECK_CLOSE(turned[1], 1.0);
+
+    return check_failures;
+}
@@ -0,0 +1,35 @@
+#include <vector>
+#include "geometry.h"
+#include "renderer.h"
+#include "check.h"
+
+using namespace Geometry;
+
+// The benchmark scene covers part of the image and leaves sky around it, whatever the threads
+int main (void) {
+    BVH bvh, empty;
+    Renderer::benchmarkScene(bvh, 4);
+    empty.build();
+
+    // Tiles of 10 don't divide 64 x 48
+    const Camera camera = Renderer::benchmarkCamera(64, 48, 4);
+    Renderer renderer(bvh, camera, 10), sky(empty, camera, 10);
+
+    const Renderer::Stats stats = renderer.render(2);
+    CHECK(stats.threads == 2 && stats.rays == 64 * 48 && stats.time >= 0.0);
+    sky.render(1);
+
+    const std::vector<unsigned char> &image = renderer.getImage(), &background = sky.getImage();
+    CHECK(image.size() == 3 * 64 * 48);
+    unsigned shapes = 0;
+    for (std::size_t pixel = 0; pixel < image.size(); pixel += 3) {
+        shapes += image[pixel] != background[pixel] || image[pixel + 1] != background[pixel + 1] || image[pixel + 2] != background[pixel + 2];
+    }
+    CHECK(shapes > 0 && shapes < 64 * 48);
+
+    const std::vector<unsigned char> threaded = image;
+    renderer.render(1);
+    CHECK(renderer.getImage() == threaded);
+
+    return check_failures;
+}
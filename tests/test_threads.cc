@@ -0,0 +1,45 @@
+#include <thread>
+#include <vector>
+#include "geometry.h"
+#include "check.h"
+
+using namespace Geometry;
+
+// The static helpers hammered from several threads at once, each thread checking its own
+// results: run by make tsan under ThreadSanitizer, which fails on any race between them
+int main (void) {
+    constexpr unsigned thread_count = 8, iterations = 20000;
+    const Cylinder cylinder(Vec<3>::origin, Vec<3>::axisZ, 2.0, 1.0);
+
+    std::vector<std::thread> threads;
+    std::vector<unsigned> failures(thread_count, 0);
+    for (unsigned thread = 0; thread < thread_count; ++thread) {
+        threads.emplace_back([&cylinder, &failures, thread] () {
+            unsigned &failed = failures[thread];
+            Camera camera;
+            for (unsigned i = 0; i < iterations; ++i) {
+                const Vec<3> from = Vec<3>::random(-1.0, 1.0).normalized(), to = Vec<3>::random(-1.0, 1.0).normalized();
+                const Vec<3> axis = Vec<3>::axis(i % 3);
+                failed += axis[i % 3] != 1.0 || axis.length2() != 1.0;
+
+                const Quaternion difference = Quaternion::difference(from, to);
+                failed += difference.rotated(from).distance(to) > 1e3 * EPSILON;
+
+                const Quaternion turn = Quaternion::axisAngle(axis, DEG90);
+                failed += std::abs(turn.rotated(axis).distance(axis)) > 1e3 * EPSILON;
+                camera.rotate(turn);
+
+                const Vec<2> param = Parametric::Cylinder(cylinder, Vec<3>{ from[0], from[1], 1.0 });
+                failed += !(param[0] == param[0] && param[1] == param[1]);
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    for (unsigned thread_failures : failures) {
+        CHECK(thread_failures == 0);
+    }
+
+    return check_failures;
+}
@@ -0,0 +1,104 @@
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "geometry.h"
+#include "check.h"
+
+using namespace Geometry;
+
+static std::mt19937 generator(1);
+
+static Vec<3> point (void) {
+    std::uniform_real_distribution<float_max_t> coordinate(-2.0, 2.0);
+    return { coordinate(generator), coordinate(generator), coordinate(generator) };
+}
+
+static bool close (const Vec<3> &a, const Vec<3> &b) {
+    return a.distance(b) <= 100 * EPSILON * (1.0 + b.length());
+}
+
+// Every batched kernel against the same Vec<3> operation element by element, on counts
+// around the widths the loops get vectorized to
+static void kernels (std::size_t count) {
+    std::vector<Vec<3>> a(count), b(count);
+    for (std::size_t j = 0; j < count; ++j) {
+        a[j] = point(), b[j] = point();
+    }
+    a.push_back(Vec<3>::zero), b.push_back(point());
+    ++count;
+
+    const VecArray<3> array_a(a), array_b(b);
+    CHECK(array_a.size() == count && array_a.toVector() == a);
+    for (std::size_t j = 0; j < count; ++j) {
+        CHECK(array_a.get(j) == a[j] && array_a.lane(0)[j] == a[j][0] && array_a.lane(2)[j] == a[j][2]);
+    }
+
+    const VecArray<3> filled(count, b[0]);
+    CHECK(filled.toVector() == std::vector<Vec<3>>(count, b[0]));
+
+    VecArray<3> grown;
+    for (const Vec<3> &vec : a) {
+        grown.push_back(vec);
+    }
+    CHECK(grown.toVector() == a);
+    grown.set(0, b[0]);
+    CHECK(grown.get(0) == b[0]);
+
+    const Vec<3> offset = point(), pivot = point();
+    const float_max_t factor = -1.5;
+    const std::array<float_max_t, 16> matrix = {
+        0.0, 1.0, 0.0, 0.0,
+        -1.0, 0.0, 0.0, 0.0,
+        0.0, 0.0, 2.0, 0.0,
+        0.5, -0.25, 1.0, 1.0
+    };
+
+    const std::vector<Vec<3>>
+        sum = VecArray<3>(array_a).add(array_b).toVector(),
+        shifted = VecArray<3>(array_a).add(offset).toVector(),
+        scaled = VecArray<3>(array_a).scale(factor).toVector(),
+        crossed = array_a.cross(array_b).toVector(),
+        crossed_vec = array_a.cross(offset).toVector(),
+        normalized = array_a.normalized().toVector(),
+        transformed = array_a.transformed(matrix, pivot).toVector();
+    const std::vector<float_max_t>
+        dot = array_a.dot(array_b),
+        dot_vec = array_a.dot(offset),
+        length2 = array_a.length2(),
+        distance2 = array_a.distance2(offset);
+
+    for (std::size_t j = 0; j < count; ++j) {
+        CHECK(close(sum[j], a[j] + b[j]));
+        CHECK(close(shifted[j], a[j] + offset));
+        CHECK(close(scaled[j], a[j] * factor));
+        CHECK(close(crossed[j], a[j].cross(b[j])));
+        CHECK(close(crossed_vec[j], a[j].cross(offset)));
+        CHECK(close(normalized[j], a[j].normalized()));
+        CHECK(close(transformed[j], a[j].transformed(matrix, pivot)));
+        CHECK_CLOSE(dot[j], a[j].dot(b[j]));
+        CHECK_CLOSE(dot_vec[j], a[j].dot(offset));
+        CHECK_CLOSE(length2[j], a[j].length2());
+        CHECK_CLOSE(distance2[j], a[j].distance2(offset));
+    }
+
+    // The zero vector at the end is left untouched by normalize, as by Vec::normalize
+    CHECK(normalized.back() == Vec<3>::zero);
+}
+
+int main (void) {
+    for (std::size_t count : { 0, 1, 3, 7, 8, 33 }) {
+        kernels(count);
+    }
+
+    // Element-wise kernels need arrays of the same size
+    const VecArray<3> three(3), four(4);
+    bool thrown = false;
+    try {
+        three.dot(four);
+    } catch (const std::invalid_argument &) {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    return check_failures;
+}
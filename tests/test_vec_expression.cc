@@ -0,0 +1,70 @@
+#include <stdexcept>
+#include "vec.h"
+#include "check.h"
+
+using namespace Geometry;
+
+static Vec<3> make (float_max_t x, float_max_t y, float_max_t z) {
+    return { x, y, z };
+}
+
+// Writes over the stack a dangling temporary would have lived in
+static float_max_t clobber (void) {
+    volatile float_max_t values[64];
+    for (unsigned i = 0; i < 64; ++i) {
+        values[i] = -1000.0 - i;
+    }
+    return values[7];
+}
+
+int main (void) {
+    const Vec<3> a = { 1.0, 2.0, 3.0 }, b = { 4.0, 5.0, 6.0 }, c = { 0.5, 0.5, 0.5 };
+
+    // Fused expressions give what one operator at a time would
+    const Vec<3> fused = a + b * 1.5 - c;
+    CHECK_CLOSE(fused[0], 6.5);
+    CHECK_CLOSE(fused[1], 9.0);
+    CHECK_CLOSE(fused[2], 11.5);
+
+    const Vec<3> scalar_first = 1.0 - a, divided = 6.0 / b;
+    CHECK_CLOSE(scalar_first[2], -2.0);
+    CHECK_CLOSE(divided[0], 1.5);
+
+    Vec<3> compound = a;
+    compound += b * 2.0;
+    compound -= c;
+    compound *= 2.0;
+    CHECK_CLOSE(compound[0], 17.0);
+
+    // Components of an expression, without a Vec in between
+    CHECK_CLOSE((a + b)[0], 5.0);
+    CHECK_CLOSE((a + b)[-1], 9.0);
+    CHECK_CLOSE((-(a - b))[1], 3.0);
+    bool thrown = false;
+    try {
+        (a + b)[3];
+    } catch (const std::out_of_range &) {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    // Temporaries are owned by the expression, which can outlive the statement
+    const auto left = make(1.0, 2.0, 3.0) + a;
+    const auto right = a * make(2.0, 2.0, 2.0);
+    const auto both = make(1.0, 1.0, 1.0) - make(0.0, 1.0, 2.0);
+    const auto scaled = 2.0 * make(1.0, 2.0, 3.0) / 4.0;
+    const auto negated = -make(1.0, 2.0, 3.0);
+    const auto nested = (make(1.0, 0.0, 0.0) + b) * make(0.5, 0.5, 0.5);
+    CHECK(clobber() < 0.0);
+
+    const Vec<3> left_value = left, right_value = right, both_value = both, scaled_value = scaled, negated_value = negated, nested_value = nested;
+    CHECK_CLOSE(left_value[2], 6.0);
+    CHECK_CLOSE(right_value[1], 4.0);
+    CHECK_CLOSE(both_value[2], -1.0);
+    CHECK_CLOSE(scaled_value[2], 1.5);
+    CHECK_CLOSE(negated_value[0], -1.0);
+    CHECK_CLOSE(nested_value[0], 2.5);
+    CHECK_CLOSE(left.dot(right), 56.0);
+
+    return check_failures;
+}
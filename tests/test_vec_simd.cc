@@ -0,0 +1,36 @@
+#include "vec.h"
+#include "check.h"
+
+using namespace Geometry;
+
+// The SSE/AVX kernels of Vec<3> and Vec<4> against plain loops over the components
+int main (void) {
+    for (unsigned i = 0; i < 1000; ++i) {
+        const Vec<3> a = Vec<3>::random(-10.0, 10.0), b = Vec<3>::random(-10.0, 10.0);
+        const float_max_t *pa = a.data(), *pb = b.data();
+
+        float_max_t dot = 0.0, distance2 = 0.0;
+        for (unsigned k = 0; k < 3; ++k) {
+            dot += pa[k] * pb[k];
+            distance2 += (pa[k] - pb[k]) * (pa[k] - pb[k]);
+        }
+        CHECK_CLOSE(a.dot(b), dot);
+        CHECK_CLOSE(a.distance2(b), distance2);
+        CHECK_CLOSE(a.length2(), a.dot(a));
+
+        const Vec<3> cross = a.cross(b);
+        CHECK_CLOSE(cross[0], pa[1] * pb[2] - pb[1] * pa[2]);
+        CHECK_CLOSE(cross[1], pa[2] * pb[0] - pb[2] * pa[0]);
+        CHECK_CLOSE(cross[2], pa[0] * pb[1] - pb[0] * pa[1]);
+
+        const Vec<4> c = Vec<4>::random(-10.0, 10.0), d = Vec<4>::random(-10.0, 10.0);
+        const float_max_t *pc = c.data(), *pd = d.data();
+        float_max_t dot4 = 0.0;
+        for (unsigned k = 0; k < 4; ++k) {
+            dot4 += pc[k] * pd[k];
+        }
+        CHECK_CLOSE(c.dot(d), dot4);
+    }
+
+    return check_failures;
+}
@@ -0,0 +1,92 @@
+#include "thread_pool.h"
+
+namespace Geometry {
+
+    ThreadPool::ThreadPool (unsigned threads) : stopping(false) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned i = 1; i < threads; ++i) {
+            this->workers.emplace_back(&ThreadPool::work, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool (void) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->stopping = true;
+        }
+        this->condition.notify_all();
+        for (std::thread &worker : this->workers) {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::work (void) {
+        for (;;) {
+            std::function<void(void)> task;
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->condition.wait(lock, [ this ] (void) { return this->stopping || !this->tasks.empty(); });
+                if (this->tasks.empty()) {
+                    return;
+                }
+                task = std::move(this->tasks.front());
+                this->tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    bool ThreadPool::runOne (void) {
+        std::function<void(void)> task;
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (this->tasks.empty()) {
+                return false;
+            }
+            task = std::move(this->tasks.back());
+            this->tasks.pop_back();
+        }
+        task();
+        return true;
+    }
+
+    void ThreadPool::run (Group &group, std::function<void(void)> task) {
+        ++group.pending;
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->tasks.emplace_back([ this, &group, task ] (void) {
+                try {
+                    task();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(group.error_mutex);
+                    if (!group.error) {
+                        group.error = std::current_exception();
+                    }
+                }
+                if (--group.pending == 0) {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->waiting.notify_all();
+                }
+            });
+        }
+        this->condition.notify_one();
+        this->waiting.notify_all();
+    }
+
+    // The newest tasks are taken here, which are usually the ones this thread just queued. The
+    // group is only checked under the mutex before sleeping, its last task taking the mutex to
+    // wake the waiters, so the wake up can't be missed.
+    void ThreadPool::wait (Group &group) {
+        while (group.pending != 0) {
+            if (!this->runOne()) {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->waiting.wait(lock, [ this, &group ] (void) { return group.pending == 0 || !this->tasks.empty(); });
+            }
+        }
+        if (group.error) {
+            std::rethrow_exception(group.error);
+        }
+    }
+};
@@ -0,0 +1,109 @@
+#ifndef MODULE_GRAPHICS_GEOMETRY_THREAD_POOL_H_
+#define MODULE_GRAPHICS_GEOMETRY_THREAD_POOL_H_
+
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <algorithm>
+
+namespace Geometry {
+
+    // Fixed set of worker threads running queued tasks. Tasks are counted per Group, and
+    // wait() runs queued tasks while the group is busy, so a task can split its work into
+    // more tasks and wait on them without starving the pool. With nothing queued, wait()
+    // sleeps until a task is queued or the group is done. A pool of one thread has no
+    // workers: everything runs on the caller inside wait().
+    class ThreadPool {
+
+    public:
+
+        class Group {
+
+            friend class ThreadPool;
+
+            std::atomic<unsigned> pending;
+            std::exception_ptr error;
+            std::mutex error_mutex;
+
+        public:
+
+            Group (void) : pending(0) {}
+        };
+
+    private:
+
+        std::vector<std::thread> workers;
+        std::deque<std::function<void(void)>> tasks;
+        std::mutex mutex;
+        std::condition_variable condition, waiting;
+        bool stopping;
+
+        void work (void);
+        bool runOne (void);
+
+    public:
+
+        // 0 threads means one per hardware thread
+        explicit ThreadPool (unsigned threads = 0);
+        ~ThreadPool (void);
+
+        ThreadPool (const ThreadPool &) = delete;
+        ThreadPool &operator = (const ThreadPool &) = delete;
+
+        // Threads doing work during wait(), counting the caller
+        inline unsigned size (void) const { return this->workers.size() + 1; }
+
+        void run (Group &group, std::function<void(void)> task);
+
+        // Rethrows the first exception thrown by a task of the group
+        void wait (Group &group);
+
+        // function(from, to) over [begin, end) split in chunks of at least grain elements
+        template <typename FUNCTION>
+        void parallelFor (std::size_t begin, std::size_t end, std::size_t grain, const FUNCTION &function) {
+            if (begin >= end) {
+                return;
+            }
+            const std::size_t
+                count = end - begin,
+                chunks = std::max<std::size_t>(1, std::min<std::size_t>(4 * this->size(), count / std::max<std::size_t>(grain, 1))),
+                chunk = (count + chunks - 1) / chunks;
+
+            Group group;
+            for (std::size_t from = begin; from < end; from += chunk) {
+                const std::size_t to = std::min(from + chunk, end);
+                this->run(group, [ &function, from, to ] (void) { function(from, to); });
+            }
+            this->wait(group);
+        }
+
+        // Same as parallelFor for uneven work: a task per thread, each taking the next grain
+        // elements from a shared counter until none is left, so fast threads take the slow ones' share
+        template <typename FUNCTION>
+        void parallelForDynamic (std::size_t begin, std::size_t end, std::size_t grain, const FUNCTION &function) {
+            if (begin >= end) {
+                return;
+            }
+            grain = std::max<std::size_t>(grain, 1);
+            const std::size_t tasks = std::min<std::size_t>(this->size(), (end - begin + grain - 1) / grain);
+            std::atomic<std::size_t> next(begin);
+
+            Group group;
+            for (std::size_t task = 0; task < tasks; ++task) {
+                this->run(group, [ &function, &next, end, grain ] (void) {
+                    for (std::size_t from = next.fetch_add(grain); from < end; from = next.fetch_add(grain)) {
+                        function(from, std::min(from + grain, end));
+                    }
+                });
+            }
+            this->wait(group);
+        }
+    };
+};
+
+#endif
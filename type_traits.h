@@ -41,6 +41,15 @@ namespace Geometry {
         static constexpr TYPE value = std::max(Head, static_max<TYPE, Next, Tail...>::value);
     };
 
+    // Smallest Root with Root * Root >= Value
+    template <unsigned Value, unsigned Root = 0, bool Done = (Root * Root >= Value)>
+    struct static_ceil_sqrt : static_ceil_sqrt<Value, Root + 1> {};
+
+    template <unsigned Value, unsigned Root>
+    struct static_ceil_sqrt<Value, Root, true> {
+        static constexpr unsigned value = Root;
+    };
+
     template <int From, int To, int Diff = To - From, int... Seq>
     struct static_range : std::conditional<
         Diff < 0,
@@ -1,7 +1,16 @@
+#include <thread>
 #include "vec.h"
 
 namespace Geometry {
 
-    bool __default_bool_;
+    std::mt19937 &randomGenerator (void) {
+        thread_local std::mt19937 generator(
+            static_cast<std::mt19937::result_type>(
+                std::chrono::system_clock::now().time_since_epoch().count() ^
+                std::hash<std::thread::id>()(std::this_thread::get_id())
+            )
+        );
+        return generator;
+    }
 
 };
@@ -13,9 +13,12 @@
 #include <iostream>
 #include <chrono>
 #include <random>
+#include <utility>
 #include <cmath>
 #include "defaults.h"
 #include "type_traits.h"
+#include "vec_expression.h"
+#include "vec_simd.h"
 
 #define MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_ITERATOR(TYPE) \
 template < \
@@ -41,6 +44,19 @@ template < \
     >::type \
 >
 
+#define MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_OPERAND(SIZE, TYPE) \
+template < \
+    typename ITERATIVE, \
+    typename = typename std::enable_if< \
+        !is_vec_expression<ITERATIVE, SIZE, TYPE>::value && \
+        std::is_trivially_constructible< \
+            TYPE, \
+            typename std::iterator_traits<typename ITERATIVE::iterator>::value_type \
+        >::value, \
+        typename ITERATIVE::iterator \
+    >::type \
+>
+
 #define MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE) \
 template < \
     typename CONSTRUCTIBLE, \
@@ -108,10 +124,11 @@ namespace Geometry {
 
     };
 
-    extern bool __default_bool_;
+    // Per-thread generator, seeded from the clock and the thread id
+    std::mt19937 &randomGenerator (void);
 
     template <unsigned SIZE, typename TYPE = float_max_t>
-    class Vec {
+    class Vec : public VecExpression<Vec<SIZE, TYPE>, SIZE, TYPE> {
 
         static_assert(SIZE > 0, "Vec size should be bigger than zero.");
 
@@ -128,12 +145,23 @@ namespace Geometry {
         inline static TYPE &_div_in (TYPE &a, const TYPE &b) { return a /= b; }
 
 
+        struct _Axis {};
+
+        template <unsigned... POSITIONS>
+        inline constexpr Vec (_Axis, unsigned position, std::integer_sequence<unsigned, POSITIONS...>) :
+            store{{ static_cast<TYPE>(POSITIONS == position)... }} {}
+
+        inline constexpr Vec (_Axis, unsigned position) :
+            Vec<SIZE, TYPE>(_Axis(), position, std::make_integer_sequence<unsigned, SIZE>()) {}
+
     protected:
 
-        std::array<TYPE, SIZE> store;
+        alignas(VecKernel<SIZE, TYPE>::alignment) std::array<TYPE, SIZE> store;
 
     public:
 
+        static constexpr bool leaf = true;
+
         typedef typename std::array<TYPE, SIZE>::iterator iterator;
         typedef typename std::array<TYPE, SIZE>::const_iterator const_iterator;
 
@@ -150,28 +178,14 @@ namespace Geometry {
             return Vec<SIZE, TYPE>::zero;
         }
 
-        inline static const Vec<SIZE, TYPE> &axis (unsigned position) {
-            static std::array<Vec<SIZE, TYPE>, SIZE> axes;
-            static bool initialized = false;
-            static Vec<SIZE, TYPE> zero;
-            if (!initialized) {
-                for (unsigned i = 0; i < SIZE; ++i) {
-                    zero.store[i] = static_cast<TYPE>(0);
-                    for (unsigned j = 0; j < SIZE; ++j) {
-                        axes[i].store[j] = static_cast<TYPE>(i == j);
-                    }
-                }
-                initialized = true;
-            }
-            if (position < SIZE) {
-                return axes[position];
-            }
-            return zero;
+        // Any position past the last one gives the zero vector
+        inline static constexpr Vec<SIZE, TYPE> axis (unsigned position) {
+            return Vec<SIZE, TYPE>(_Axis(), position);
         }
 
         inline static Vec<SIZE, TYPE> random (TYPE min_val = static_cast<TYPE>(0), TYPE max_val = static_cast<TYPE>(1)) {
 
-            static std::mt19937 gen(std::chrono::system_clock::now().time_since_epoch().count());
+            std::mt19937 &gen = randomGenerator();
             std::uniform_real_distribution<TYPE> value(min_val, max_val);
             Vec<SIZE, TYPE> result;
 
@@ -209,6 +223,13 @@ namespace Geometry {
         inline Vec (const std::initializer_list<TYPE> &_copy, TYPE fill = static_cast<TYPE>(0)) :
             Vec<SIZE, TYPE>(std::begin(_copy), std::end(_copy), fill) {}
 
+        template <typename EXPR>
+        inline Vec (const VecExpression<EXPR, SIZE, TYPE> &expression) {
+            for (unsigned i = 0; i < SIZE; ++i) {
+                this->store[i] = expression.evaluate(i);
+            }
+        }
+
 // -------------------------------------
 
         inline constexpr Vec<SIZE, TYPE> &operator = (Vec<SIZE, TYPE> &&other) { return this->swap(other); }
@@ -218,6 +239,14 @@ namespace Geometry {
             return *this;
         }
 
+        template <typename EXPR>
+        inline Vec<SIZE, TYPE> &operator = (const VecExpression<EXPR, SIZE, TYPE> &expression) {
+            for (unsigned i = 0; i < SIZE; ++i) {
+                this->store[i] = expression.evaluate(i);
+            }
+            return *this;
+        }
+
 // -----------------------------------------------------------------------------
 
         inline constexpr Vec<SIZE, TYPE> &swap (Vec<SIZE, TYPE> &other) {
@@ -245,6 +274,8 @@ namespace Geometry {
         inline constexpr unsigned size (void) const { return SIZE; }
         inline const TYPE *data (void) const { return this->store.data(); }
 
+        inline constexpr const TYPE &evaluate (unsigned position) const { return this->store[position]; }
+
 // -------------------------------------
 
         inline constexpr operator bool(void) const { return (*this) != zero; }
@@ -294,16 +325,6 @@ namespace Geometry {
             return in;
         }
 
-// -------------------------------------
-
-        inline constexpr Vec<SIZE, TYPE> operator - (void) const {
-            Vec<SIZE, TYPE> result;
-            for (unsigned i = 0; i < SIZE; ++i) {
-                result.store[i] = -this->store[i];
-            }
-            return result;
-        }
-
 // -----------------------------------------------------------------------------
 
         template <typename RANGES>
@@ -382,23 +403,17 @@ namespace Geometry {
 
 // -------------------------------------
 
-        constexpr TYPE dot (const Vec<SIZE, TYPE> &other) const {
-            TYPE result = static_cast<TYPE>(0);
-            for (unsigned i = 0; i < SIZE; ++i) {
-                result += other[i] * this->store[i];
-            }
-            return result;
+        inline TYPE dot (const Vec<SIZE, TYPE> &other) const {
+            return VecKernel<SIZE, TYPE>::dot(this->store.data(), other.store.data());
         }
 
 // -------------------------------------
 
         MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_EQUAL(SIZE, 3)
-        inline constexpr Vec<3, TYPE> cross (const Vec<3, TYPE> &other) const {
-            return {
-                this->store[1] * other[2] - other[1] * this->store[2],
-                this->store[2] * other[0] - other[2] * this->store[0],
-                this->store[0] * other[1] - other[0] * this->store[1]
-            };
+        inline Vec<3, TYPE> cross (const Vec<3, TYPE> &other) const {
+            Vec<3, TYPE> result;
+            VecKernel<3, TYPE>::cross(this->store.data(), other.store.data(), result.store.data());
+            return result;
         }
 
 // -------------------------------------
@@ -415,13 +430,8 @@ namespace Geometry {
 
 // -----------------------------------------------------------------------------
 
-        inline constexpr TYPE distance2 (const Vec<SIZE, TYPE> &other) const {
-            TYPE result = static_cast<TYPE>(0);
-            for (unsigned i = 0; i < SIZE; ++i) {
-                TYPE diff = this->store[i] - other.store[i];
-                result += diff * diff;
-            }
-            return result;
+        inline TYPE distance2 (const Vec<SIZE, TYPE> &other) const {
+            return VecKernel<SIZE, TYPE>::distance2(this->store.data(), other.store.data());
         }
 
         inline TYPE distance (const Vec<SIZE, TYPE> &other) const {
@@ -430,8 +440,8 @@ namespace Geometry {
 
 // -------------------------------------
 
-        inline constexpr TYPE length2 (void) const {
-            return this->dot(*this);
+        inline TYPE length2 (void) const {
+            return VecKernel<SIZE, TYPE>::dot(this->store.data(), this->store.data());
         }
 
         inline TYPE length (void) const {
@@ -469,7 +479,7 @@ namespace Geometry {
                 one = static_cast<TYPE>(1),
                 length2 = this->length2();
             if (length2 != zero && length2 != one) {
-                return this->resized(one);
+                return (*this) * (one / std::sqrt(length2));
             }
             return *this;
         }
@@ -480,7 +490,7 @@ namespace Geometry {
                 one = static_cast<TYPE>(1),
                 length2 = this->length2();
             if (length2 != zero && length2 != one) {
-                this->resize(one);
+                (*this) *= one / std::sqrt(length2);
             }
             return *this;
         }
@@ -543,7 +553,14 @@ namespace Geometry {
 
 // -------------------------------------
 
-        inline Vec<SIZE, TYPE> opposed (const Vec<SIZE, TYPE> &other, bool &changed = __default_bool_) const {
+        inline Vec<SIZE, TYPE> opposed (const Vec<SIZE, TYPE> &other) const {
+            if (this->dot(other) > 0) {
+                return -(*this);
+            }
+            return *this;
+        }
+
+        inline Vec<SIZE, TYPE> opposed (const Vec<SIZE, TYPE> &other, bool &changed) const {
             if (this->dot(other) > 0) {
                 changed = true;
                 return -(*this);
@@ -552,7 +569,12 @@ namespace Geometry {
             return *this;
         }
 
-        inline Vec<SIZE, TYPE> &oppose (const Vec<SIZE, TYPE> &other, bool &changed = __default_bool_) {
+        inline Vec<SIZE, TYPE> &oppose (const Vec<SIZE, TYPE> &other) {
+            bool changed;
+            return this->oppose(other, changed);
+        }
+
+        inline Vec<SIZE, TYPE> &oppose (const Vec<SIZE, TYPE> &other, bool &changed) {
             if (this->dot(other) > 0) {
                 changed = true;
                 for (unsigned i = 0; i < SIZE; ++i) {
@@ -616,73 +638,97 @@ namespace Geometry {
 
 // -----------------------------------------------------------------------------
 
-        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE)
-        friend Vec<SIZE, TYPE> operator + (const CONSTRUCTIBLE &other, const Vec<SIZE, TYPE> &vec) { return vec.mapped([ other ] (const TYPE &a) { return _add_out(a, other); }); }
-        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE)
-        friend Vec<SIZE, TYPE> operator + (const Vec<SIZE, TYPE> &vec, const CONSTRUCTIBLE &other) { return vec.mapped([ other ] (const TYPE &a) { return _add_out(a, other); }); }
-        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_ITERATIVE(TYPE)
-        Vec<SIZE, TYPE> operator + (const ITERATIVE &other) const { return this->mapped(_add_out, std::begin(other), std::end(other)); }
-        // MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE)
-        // friend Vec<SIZE, TYPE> operator + (const Vec<SIZE, TYPE> &vec, const std::initializer_list<CONSTRUCTIBLE> &other) { return vec.mapped(_add_out, std::begin(other), std::end(other)); }
-        // MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE)
-        // friend Vec<SIZE, TYPE> operator + (const std::initializer_list<CONSTRUCTIBLE> &other, const Vec<SIZE, TYPE> &vec) { return vec.mapped(_add_out, std::begin(other), std::end(other)); }
+        // Vec op Vec and Vec op scalar are lazy, see vec_expression.h
 
+        template <typename EXPR>
+        inline Vec<SIZE, TYPE> &operator += (const VecExpression<EXPR, SIZE, TYPE> &other) {
+            for (unsigned i = 0; i < SIZE; ++i) {
+                this->store[i] += other.evaluate(i);
+            }
+            return *this;
+        }
 
         MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE)
-        friend Vec<SIZE, TYPE> &operator += (const CONSTRUCTIBLE &other, Vec<SIZE, TYPE> &vec) { return vec.map([ other ] (TYPE &a) { _add_in(a, other); }); }
+        friend Vec<SIZE, TYPE> &operator += (const CONSTRUCTIBLE &other, Vec<SIZE, TYPE> &vec) { return vec += other; }
         MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE)
-        friend Vec<SIZE, TYPE> &operator += (Vec<SIZE, TYPE> &vec, const CONSTRUCTIBLE &other) { return vec.map([ other ] (TYPE &a) { _add_in(a, other); }); }
-        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_ITERATIVE(TYPE)
+        friend Vec<SIZE, TYPE> &operator += (Vec<SIZE, TYPE> &vec, const CONSTRUCTIBLE &other) {
+            for (unsigned i = 0; i < SIZE; ++i) {
+                vec.store[i] += other;
+            }
+            return vec;
+        }
+
+        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_OPERAND(SIZE, TYPE)
+        Vec<SIZE, TYPE> operator + (const ITERATIVE &other) const { return this->mapped(_add_out, std::begin(other), std::end(other)); }
+        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_OPERAND(SIZE, TYPE)
         Vec<SIZE, TYPE> &operator += (const ITERATIVE &other) { return this->map(_add_in, std::begin(other), std::end(other)); }
         Vec<SIZE, TYPE> &operator += (const std::initializer_list<TYPE> &other) { return this->map(_add_in, std::begin(other), std::end(other)); }
 
 // -------------------------------------
 
+        template <typename EXPR>
+        inline Vec<SIZE, TYPE> &operator -= (const VecExpression<EXPR, SIZE, TYPE> &other) {
+            for (unsigned i = 0; i < SIZE; ++i) {
+                this->store[i] -= other.evaluate(i);
+            }
+            return *this;
+        }
+
         MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE)
-        friend Vec<SIZE, TYPE> operator - (const CONSTRUCTIBLE &other, const Vec<SIZE, TYPE> &vec) { return vec.mapped([ other ] (const TYPE &a) { return _sub_out(a, other); }); }
+        friend Vec<SIZE, TYPE> &operator -= (const CONSTRUCTIBLE &other, Vec<SIZE, TYPE> &vec) { return vec -= other; }
         MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE)
-        friend Vec<SIZE, TYPE> operator - (const Vec<SIZE, TYPE> &vec, const CONSTRUCTIBLE &other) { return vec.mapped([ other ] (const TYPE &a) { return _sub_out(a, other); }); }
-        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_ITERATIVE(TYPE)
+        friend Vec<SIZE, TYPE> &operator -= (Vec<SIZE, TYPE> &vec, const CONSTRUCTIBLE &other) {
+            for (unsigned i = 0; i < SIZE; ++i) {
+                vec.store[i] -= other;
+            }
+            return vec;
+        }
+
+        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_OPERAND(SIZE, TYPE)
         Vec<SIZE, TYPE> operator - (const ITERATIVE &other) const { return this->mapped(_sub_out, std::begin(other), std::end(other)); }
         Vec<SIZE, TYPE> operator - (const std::initializer_list<TYPE> &other) const { return this->mapped(_sub_out, std::begin(other), std::end(other)); }
-
-        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE)
-        friend Vec<SIZE, TYPE> &operator -= (const CONSTRUCTIBLE &other, Vec<SIZE, TYPE> &vec) { return vec.map([ other ] (TYPE &a) { _sub_in(a, other); }); }
-        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE)
-        friend Vec<SIZE, TYPE> &operator -= (Vec<SIZE, TYPE> &vec, const CONSTRUCTIBLE &other) { return vec.map([ other ] (TYPE &a) { _sub_in(a, other); }); }
-        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_ITERATIVE(TYPE)
+        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_OPERAND(SIZE, TYPE)
         Vec<SIZE, TYPE> &operator -= (const ITERATIVE &other) { return this->map(_sub_in, std::begin(other), std::end(other)); }
         Vec<SIZE, TYPE> &operator -= (const std::initializer_list<TYPE> &other) { return this->map(_sub_in, std::begin(other), std::end(other)); }
 
 // -------------------------------------
 
+        template <typename EXPR>
+        inline Vec<SIZE, TYPE> &operator *= (const VecExpression<EXPR, SIZE, TYPE> &other) {
+            for (unsigned i = 0; i < SIZE; ++i) {
+                this->store[i] *= other.evaluate(i);
+            }
+            return *this;
+        }
+
         MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE)
-        friend Vec<SIZE, TYPE> operator * (const CONSTRUCTIBLE &other, const Vec<SIZE, TYPE> &vec) { return vec.mapped([ other ] (const TYPE &a) { return _mul_out(a, other); }); }
+        friend Vec<SIZE, TYPE> &operator *= (const CONSTRUCTIBLE &other, Vec<SIZE, TYPE> &vec) { return vec *= other; }
         MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE)
-        friend Vec<SIZE, TYPE> operator * (const Vec<SIZE, TYPE> &vec, const CONSTRUCTIBLE &other) { return vec.mapped([ other ] (const TYPE &a) { return _mul_out(a, other); }); }
-        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_ITERATIVE(TYPE)
+        friend Vec<SIZE, TYPE> &operator *= (Vec<SIZE, TYPE> &vec, const CONSTRUCTIBLE &other) {
+            for (unsigned i = 0; i < SIZE; ++i) {
+                vec.store[i] *= other;
+            }
+            return vec;
+        }
+
+        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_OPERAND(SIZE, TYPE)
         Vec<SIZE, TYPE> operator * (const ITERATIVE &other) const { return this->mapped(_mul_out, std::begin(other), std::end(other)); }
         Vec<SIZE, TYPE> operator * (const std::initializer_list<TYPE> &other) const { return this->mapped(_mul_out, std::begin(other), std::end(other)); }
-
-        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE)
-        friend Vec<SIZE, TYPE> &operator *= (const CONSTRUCTIBLE &other, Vec<SIZE, TYPE> &vec) { return vec.map([ other ] (TYPE &a) { _mul_in(a, other); }); }
-        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE)
-        friend Vec<SIZE, TYPE> &operator *= (Vec<SIZE, TYPE> &vec, const CONSTRUCTIBLE &other) { return vec.map([ other ] (TYPE &a) { _mul_in(a, other); }); }
-        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_ITERATIVE(TYPE)
+        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_OPERAND(SIZE, TYPE)
         Vec<SIZE, TYPE> &operator *= (const ITERATIVE &other) { return this->map(_mul_in, std::begin(other), std::end(other)); }
         Vec<SIZE, TYPE> &operator *= (const std::initializer_list<TYPE> &other) { return this->map(_mul_in, std::begin(other), std::end(other)); }
 
 // -------------------------------------
-//
-        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE)
-        friend Vec<SIZE, TYPE> operator / (const CONSTRUCTIBLE &other, const Vec<SIZE, TYPE> &vec) { return vec.mapped([ other ] (const TYPE &a) { return _div_out(a, other); }); }
-        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE)
-        friend Vec<SIZE, TYPE> operator / (const Vec<SIZE, TYPE> &vec, const CONSTRUCTIBLE &other) { return vec.mapped([ other ] (const TYPE &a) { return _div_out(a, other); }); }
 
         MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE)
-        friend Vec<SIZE, TYPE> &operator /= (const CONSTRUCTIBLE &other, Vec<SIZE, TYPE> &vec) { return vec.map([ other ] (TYPE &a) { _div_in(a, other); }); }
+        friend Vec<SIZE, TYPE> &operator /= (const CONSTRUCTIBLE &other, Vec<SIZE, TYPE> &vec) { return vec /= other; }
         MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_CONSTRUCTIBLE(TYPE)
-        friend Vec<SIZE, TYPE> &operator /= (Vec<SIZE, TYPE> &vec, const CONSTRUCTIBLE &other) { return vec.map([ other ] (TYPE &a) { _div_in(a, other); }); }
+        friend Vec<SIZE, TYPE> &operator /= (Vec<SIZE, TYPE> &vec, const CONSTRUCTIBLE &other) {
+            for (unsigned i = 0; i < SIZE; ++i) {
+                vec.store[i] /= other;
+            }
+            return vec;
+        }
 
 // -----------------------------------------------------------------------------
 
@@ -695,22 +741,25 @@ namespace Geometry {
     constexpr std::array<int, Filter::Ranges<RANGES...>::size> Filter::Ranges<RANGES...>::ends;
 
     template <unsigned SIZE, typename TYPE>
-    const Vec<SIZE, TYPE> Vec<SIZE, TYPE>::axisX = Vec<SIZE, TYPE>::axis(0);
+    constexpr bool Vec<SIZE, TYPE>::leaf;
+
+    template <unsigned SIZE, typename TYPE>
+    const Vec<SIZE, TYPE> Vec<SIZE, TYPE>::axisX(Vec<SIZE, TYPE>::_Axis(), 0);
 
     template <unsigned SIZE, typename TYPE>
-    const Vec<SIZE, TYPE> Vec<SIZE, TYPE>::axisY = Vec<SIZE, TYPE>::axis(1);
+    const Vec<SIZE, TYPE> Vec<SIZE, TYPE>::axisY(Vec<SIZE, TYPE>::_Axis(), 1);
 
     template <unsigned SIZE, typename TYPE>
-    const Vec<SIZE, TYPE> Vec<SIZE, TYPE>::axisZ = Vec<SIZE, TYPE>::axis(2);
+    const Vec<SIZE, TYPE> Vec<SIZE, TYPE>::axisZ(Vec<SIZE, TYPE>::_Axis(), 2);
 
     template <unsigned SIZE, typename TYPE>
-    const Vec<SIZE, TYPE> Vec<SIZE, TYPE>::axisW = Vec<SIZE, TYPE>::axis(3);
+    const Vec<SIZE, TYPE> Vec<SIZE, TYPE>::axisW(Vec<SIZE, TYPE>::_Axis(), 3);
 
     template <unsigned SIZE, typename TYPE>
-    const Vec<SIZE, TYPE> Vec<SIZE, TYPE>::zero = Vec<SIZE, TYPE>::axis(SIZE);
+    const Vec<SIZE, TYPE> Vec<SIZE, TYPE>::zero(Vec<SIZE, TYPE>::_Axis(), SIZE);
 
     template <unsigned SIZE, typename TYPE>
-    const Vec<SIZE, TYPE> Vec<SIZE, TYPE>::origin = Vec<SIZE, TYPE>::zero;
+    const Vec<SIZE, TYPE> Vec<SIZE, TYPE>::origin(Vec<SIZE, TYPE>::_Axis(), SIZE);
 };
 
 #endif
@@ -0,0 +1,295 @@
+#ifndef MODULE_GRAPHICS_GEOMETRY_VEC_ARRAY_H_
+#define MODULE_GRAPHICS_GEOMETRY_VEC_ARRAY_H_
+
+#include <stdexcept>
+#include <array>
+#include <vector>
+#include <cmath>
+#include "defaults.h"
+#include "vec.h"
+
+namespace Geometry {
+
+    // Structure of arrays: one contiguous lane per component, so every batched
+    // operation is a straight loop over plain arrays that the compiler vectorizes.
+    template <unsigned SIZE, typename TYPE = float_max_t>
+    class VecArray {
+
+        static_assert(SIZE > 0, "VecArray size should be bigger than zero.");
+
+        std::array<std::vector<TYPE>, SIZE> lanes;
+
+        inline void checkSize (const VecArray<SIZE, TYPE> &other) const {
+            if (other.size() != this->size()) {
+                throw std::invalid_argument(std::to_string(other.size()) + " elements given to VecArray of " + std::to_string(this->size()) + " elements");
+            }
+        }
+
+    public:
+
+        inline VecArray (void) {}
+
+        inline explicit VecArray (std::size_t count, const Vec<SIZE, TYPE> &fill = Vec<SIZE, TYPE>::zero) {
+            for (unsigned i = 0; i < SIZE; ++i) {
+                this->lanes[i].assign(count, fill[i]);
+            }
+        }
+
+        inline VecArray (const std::vector<Vec<SIZE, TYPE>> &vecs) {
+            const std::size_t count = vecs.size();
+            for (unsigned i = 0; i < SIZE; ++i) {
+                this->lanes[i].resize(count);
+            }
+            for (std::size_t j = 0; j < count; ++j) {
+                const TYPE *values = vecs[j].data();
+                for (unsigned i = 0; i < SIZE; ++i) {
+                    this->lanes[i][j] = values[i];
+                }
+            }
+        }
+
+        std::vector<Vec<SIZE, TYPE>> toVector (void) const {
+            const std::size_t count = this->size();
+            std::vector<Vec<SIZE, TYPE>> result(count);
+            for (std::size_t j = 0; j < count; ++j) {
+                result[j] = this->get(j);
+            }
+            return result;
+        }
+
+// -----------------------------------------------------------------------------
+
+        inline std::size_t size (void) const { return this->lanes[0].size(); }
+        inline bool empty (void) const { return this->lanes[0].empty(); }
+
+        inline void reserve (std::size_t count) {
+            for (unsigned i = 0; i < SIZE; ++i) {
+                this->lanes[i].reserve(count);
+            }
+        }
+
+        inline void resize (std::size_t count) {
+            for (unsigned i = 0; i < SIZE; ++i) {
+                this->lanes[i].resize(count);
+            }
+        }
+
+        inline void clear (void) {
+            for (unsigned i = 0; i < SIZE; ++i) {
+                this->lanes[i].clear();
+            }
+        }
+
+        inline void push_back (const Vec<SIZE, TYPE> &vec) {
+            for (unsigned i = 0; i < SIZE; ++i) {
+                this->lanes[i].push_back(vec[i]);
+            }
+        }
+
+// -------------------------------------
+
+        inline TYPE *lane (unsigned component) { return this->lanes[component].data(); }
+        inline const TYPE *lane (unsigned component) const { return this->lanes[component].data(); }
+
+        inline Vec<SIZE, TYPE> get (std::size_t position) const {
+            Vec<SIZE, TYPE> result;
+            for (unsigned i = 0; i < SIZE; ++i) {
+                result[i] = this->lanes[i][position];
+            }
+            return result;
+        }
+
+        inline void set (std::size_t position, const Vec<SIZE, TYPE> &vec) {
+            for (unsigned i = 0; i < SIZE; ++i) {
+                this->lanes[i][position] = vec[i];
+            }
+        }
+
+// -----------------------------------------------------------------------------
+
+        VecArray<SIZE, TYPE> &add (const VecArray<SIZE, TYPE> &other) {
+            this->checkSize(other);
+            const std::size_t count = this->size();
+            for (unsigned i = 0; i < SIZE; ++i) {
+                TYPE *values = this->lane(i);
+                const TYPE *others = other.lane(i);
+                for (std::size_t j = 0; j < count; ++j) {
+                    values[j] += others[j];
+                }
+            }
+            return *this;
+        }
+
+        VecArray<SIZE, TYPE> &add (const Vec<SIZE, TYPE> &offset) {
+            const std::size_t count = this->size();
+            for (unsigned i = 0; i < SIZE; ++i) {
+                TYPE *values = this->lane(i);
+                const TYPE value = offset[i];
+                for (std::size_t j = 0; j < count; ++j) {
+                    values[j] += value;
+                }
+            }
+            return *this;
+        }
+
+        VecArray<SIZE, TYPE> &scale (const TYPE &factor) {
+            const std::size_t count = this->size();
+            for (unsigned i = 0; i < SIZE; ++i) {
+                TYPE *values = this->lane(i);
+                for (std::size_t j = 0; j < count; ++j) {
+                    values[j] *= factor;
+                }
+            }
+            return *this;
+        }
+
+// -------------------------------------
+
+        std::vector<TYPE> dot (const VecArray<SIZE, TYPE> &other) const {
+            this->checkSize(other);
+            const std::size_t count = this->size();
+            std::vector<TYPE> result(count, static_cast<TYPE>(0));
+            TYPE *out = result.data();
+            for (unsigned i = 0; i < SIZE; ++i) {
+                const TYPE *values = this->lane(i), *others = other.lane(i);
+                for (std::size_t j = 0; j < count; ++j) {
+                    out[j] += values[j] * others[j];
+                }
+            }
+            return result;
+        }
+
+        std::vector<TYPE> dot (const Vec<SIZE, TYPE> &other) const {
+            const std::size_t count = this->size();
+            std::vector<TYPE> result(count, static_cast<TYPE>(0));
+            TYPE *out = result.data();
+            for (unsigned i = 0; i < SIZE; ++i) {
+                const TYPE *values = this->lane(i), value = other[i];
+                for (std::size_t j = 0; j < count; ++j) {
+                    out[j] += values[j] * value;
+                }
+            }
+            return result;
+        }
+
+        std::vector<TYPE> length2 (void) const {
+            const std::size_t count = this->size();
+            std::vector<TYPE> result(count, static_cast<TYPE>(0));
+            TYPE *out = result.data();
+            for (unsigned i = 0; i < SIZE; ++i) {
+                const TYPE *values = this->lane(i);
+                for (std::size_t j = 0; j < count; ++j) {
+                    out[j] += values[j] * values[j];
+                }
+            }
+            return result;
+        }
+
+        std::vector<TYPE> distance2 (const Vec<SIZE, TYPE> &point) const {
+            const std::size_t count = this->size();
+            std::vector<TYPE> result(count, static_cast<TYPE>(0));
+            TYPE *out = result.data();
+            for (unsigned i = 0; i < SIZE; ++i) {
+                const TYPE *values = this->lane(i), value = point[i];
+                for (std::size_t j = 0; j < count; ++j) {
+                    const TYPE diff = values[j] - value;
+                    out[j] += diff * diff;
+                }
+            }
+            return result;
+        }
+
+// -------------------------------------
+
+        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_EQUAL(SIZE, 3)
+        VecArray<3, TYPE> cross (const VecArray<3, TYPE> &other) const {
+            this->checkSize(other);
+            const std::size_t count = this->size();
+            VecArray<3, TYPE> result;
+            result.resize(count);
+            const TYPE
+                *ax = this->lane(0), *ay = this->lane(1), *az = this->lane(2),
+                *bx = other.lane(0), *by = other.lane(1), *bz = other.lane(2);
+            TYPE *rx = result.lane(0), *ry = result.lane(1), *rz = result.lane(2);
+            for (std::size_t j = 0; j < count; ++j) {
+                rx[j] = ay[j] * bz[j] - by[j] * az[j];
+                ry[j] = az[j] * bx[j] - bz[j] * ax[j];
+                rz[j] = ax[j] * by[j] - bx[j] * ay[j];
+            }
+            return result;
+        }
+
+        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_EQUAL(SIZE, 3)
+        VecArray<3, TYPE> cross (const Vec<3, TYPE> &other) const {
+            const std::size_t count = this->size();
+            VecArray<3, TYPE> result;
+            result.resize(count);
+            const TYPE
+                *ax = this->lane(0), *ay = this->lane(1), *az = this->lane(2),
+                bx = other[0], by = other[1], bz = other[2];
+            TYPE *rx = result.lane(0), *ry = result.lane(1), *rz = result.lane(2);
+            for (std::size_t j = 0; j < count; ++j) {
+                rx[j] = ay[j] * bz - by * az[j];
+                ry[j] = az[j] * bx - bz * ax[j];
+                rz[j] = ax[j] * by - bx * ay[j];
+            }
+            return result;
+        }
+
+// -------------------------------------
+
+        // Zero length entries are left untouched, as in Vec::normalize
+        VecArray<SIZE, TYPE> &normalize (void) {
+            const std::size_t count = this->size();
+            const TYPE zero = static_cast<TYPE>(0), one = static_cast<TYPE>(1);
+            std::vector<TYPE> factor = this->length2();
+            TYPE *factors = factor.data();
+            for (std::size_t j = 0; j < count; ++j) {
+                factors[j] = factors[j] > zero ? one / std::sqrt(factors[j]) : one;
+            }
+            for (unsigned i = 0; i < SIZE; ++i) {
+                TYPE *values = this->lane(i);
+                for (std::size_t j = 0; j < count; ++j) {
+                    values[j] *= factors[j];
+                }
+            }
+            return *this;
+        }
+
+        inline VecArray<SIZE, TYPE> normalized (void) const {
+            VecArray<SIZE, TYPE> result(*this);
+            result.normalize();
+            return result;
+        }
+
+// -------------------------------------
+
+        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_EQUAL(SIZE, 3)
+        VecArray<3, TYPE> &transform (const std::array<float_max_t, 16> &matrix, const Vec<3, TYPE> &pivot = Vec<3, TYPE>::zero) {
+            const std::size_t count = this->size();
+            const TYPE
+                m0 = matrix[0], m1 = matrix[1], m2 = matrix[2],
+                m4 = matrix[4], m5 = matrix[5], m6 = matrix[6],
+                m8 = matrix[8], m9 = matrix[9], m10 = matrix[10],
+                px = pivot[0], py = pivot[1], pz = pivot[2],
+                tx = px + matrix[12], ty = py + matrix[13], tz = pz + matrix[14];
+            TYPE *x = this->lane(0), *y = this->lane(1), *z = this->lane(2);
+            for (std::size_t j = 0; j < count; ++j) {
+                const TYPE dx = x[j] - px, dy = y[j] - py, dz = z[j] - pz;
+                x[j] = tx + dx * m0 + dy * m4 + dz * m8;
+                y[j] = ty + dx * m1 + dy * m5 + dz * m9;
+                z[j] = tz + dx * m2 + dy * m6 + dz * m10;
+            }
+            return *this;
+        }
+
+        MODULE_GRAPHICS_GEOMETRY_VEC_TEMPLATE_IS_EQUAL(SIZE, 3)
+        inline VecArray<3, TYPE> transformed (const std::array<float_max_t, 16> &matrix, const Vec<3, TYPE> &pivot = Vec<3, TYPE>::zero) const {
+            VecArray<3, TYPE> result(*this);
+            result.transform(matrix, pivot);
+            return result;
+        }
+    };
+};
+
+#endif
@@ -0,0 +1,283 @@
+#ifndef MODULE_GRAPHICS_GEOMETRY_VEC_EXPRESSION_H_
+#define MODULE_GRAPHICS_GEOMETRY_VEC_EXPRESSION_H_
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <cmath>
+#include "defaults.h"
+
+// Lazy arithmetic for Vec: every operator builds a small node instead of a Vec,
+// and the whole expression is evaluated in a single loop when it is assigned to
+// (or used to construct) a Vec. Named Vec leaves are held by reference, temporary
+// ones are moved into the expression, so an `auto` expression stays valid as long
+// as the named Vecs it uses.
+
+namespace Geometry {
+
+    template <unsigned SIZE, typename TYPE>
+    class Vec;
+
+    template <unsigned SIZE, typename TYPE>
+    class VecExpressionTag {};
+
+    template <typename EXPR, unsigned SIZE, typename TYPE>
+    class VecExpression : public VecExpressionTag<SIZE, TYPE> {
+
+    public:
+
+        static constexpr bool leaf = false;
+
+        inline constexpr const EXPR &self (void) const { return static_cast<const EXPR &>(*this); }
+        inline constexpr TYPE evaluate (unsigned position) const { return this->self().evaluate(position); }
+
+        inline constexpr unsigned size (void) const { return SIZE; }
+
+        inline Vec<SIZE, TYPE> eval (void) const { return Vec<SIZE, TYPE>(*this); }
+
+        // Same range check and negative positions as Vec, evaluating only that component
+        inline TYPE operator [] (int position) const {
+            if (position < 0) {
+                position += SIZE;
+            }
+            if (position < 0 || static_cast<unsigned>(position) >= SIZE) {
+                throw std::out_of_range(std::to_string(position) + " is out of range in Vec of size " + std::to_string(SIZE));
+            }
+            return this->evaluate(position);
+        }
+
+// -------------------------------------
+
+        constexpr TYPE sum (void) const {
+            TYPE result = static_cast<TYPE>(0);
+            for (unsigned i = 0; i < SIZE; ++i) {
+                result += this->evaluate(i);
+            }
+            return result;
+        }
+
+        constexpr TYPE prod (void) const {
+            TYPE result = static_cast<TYPE>(1);
+            for (unsigned i = 0; i < SIZE; ++i) {
+                result *= this->evaluate(i);
+            }
+            return result;
+        }
+
+        template <typename OTHER>
+        constexpr TYPE dot (const VecExpression<OTHER, SIZE, TYPE> &other) const {
+            TYPE result = static_cast<TYPE>(0);
+            for (unsigned i = 0; i < SIZE; ++i) {
+                result += this->evaluate(i) * other.evaluate(i);
+            }
+            return result;
+        }
+
+        constexpr TYPE length2 (void) const {
+            TYPE result = static_cast<TYPE>(0);
+            for (unsigned i = 0; i < SIZE; ++i) {
+                const TYPE value = this->evaluate(i);
+                result += value * value;
+            }
+            return result;
+        }
+
+        inline TYPE length (void) const { return std::sqrt(this->length2()); }
+
+        template <typename OTHER>
+        constexpr TYPE distance2 (const VecExpression<OTHER, SIZE, TYPE> &other) const {
+            TYPE result = static_cast<TYPE>(0);
+            for (unsigned i = 0; i < SIZE; ++i) {
+                const TYPE diff = this->evaluate(i) - other.evaluate(i);
+                result += diff * diff;
+            }
+            return result;
+        }
+
+        template <typename OTHER>
+        inline TYPE distance (const VecExpression<OTHER, SIZE, TYPE> &other) const { return std::sqrt(this->distance2(other)); }
+
+// -------------------------------------
+
+        inline Vec<SIZE, TYPE> normalized (void) const {
+            Vec<SIZE, TYPE> result(*this);
+            result.normalize();
+            return result;
+        }
+
+        template <
+            typename OTHER,
+            typename = typename std::enable_if<SIZE == 3, OTHER>::type
+        >
+        inline Vec<3, TYPE> cross (const VecExpression<OTHER, 3, TYPE> &other) const {
+            const TYPE
+                a0 = this->evaluate(0), a1 = this->evaluate(1), a2 = this->evaluate(2),
+                b0 = other.evaluate(0), b1 = other.evaluate(1), b2 = other.evaluate(2);
+            return { a1 * b2 - b1 * a2, a2 * b0 - b2 * a0, a0 * b1 - b0 * a1 };
+        }
+    };
+
+    template <typename EXPR, unsigned SIZE, typename TYPE>
+    constexpr bool VecExpression<EXPR, SIZE, TYPE>::leaf;
+
+// -----------------------------------------------------------------------------
+
+    template <typename EXPR, unsigned SIZE, typename TYPE>
+    struct is_vec_expression : std::is_base_of<VecExpressionTag<SIZE, TYPE>, EXPR> {};
+
+    // Vec (and anything derived from it) is held by reference, intermediate nodes by value
+    template <typename EXPR>
+    struct VecExpressionStorage {
+        typedef typename std::conditional<EXPR::leaf, const EXPR &, const EXPR>::type type;
+    };
+
+    // A temporary Vec, owned by the expression using it
+    template <unsigned SIZE, typename TYPE>
+    class VecValueExpression : public VecExpression<VecValueExpression<SIZE, TYPE>, SIZE, TYPE> {
+
+        const Vec<SIZE, TYPE> value;
+
+    public:
+
+        inline VecValueExpression (Vec<SIZE, TYPE> &&_value) : value(std::move(_value)) {}
+
+        inline constexpr TYPE evaluate (unsigned position) const { return this->value.evaluate(position); }
+    };
+
+    namespace VecOperation {
+
+        struct Add { template <typename TYPE> inline static constexpr TYPE apply (const TYPE &a, const TYPE &b) { return a + b; } };
+        struct Sub { template <typename TYPE> inline static constexpr TYPE apply (const TYPE &a, const TYPE &b) { return a - b; } };
+        struct Mul { template <typename TYPE> inline static constexpr TYPE apply (const TYPE &a, const TYPE &b) { return a * b; } };
+        struct Div { template <typename TYPE> inline static constexpr TYPE apply (const TYPE &a, const TYPE &b) { return a / b; } };
+    };
+
+// -----------------------------------------------------------------------------
+
+    template <typename LEFT, typename RIGHT, typename OPERATION, unsigned SIZE, typename TYPE>
+    class VecBinaryExpression : public VecExpression<VecBinaryExpression<LEFT, RIGHT, OPERATION, SIZE, TYPE>, SIZE, TYPE> {
+
+        typename VecExpressionStorage<LEFT>::type left;
+        typename VecExpressionStorage<RIGHT>::type right;
+
+    public:
+
+        inline constexpr VecBinaryExpression (const LEFT &_left, const RIGHT &_right) : left(_left), right(_right) {}
+
+        inline constexpr TYPE evaluate (unsigned position) const {
+            return OPERATION::apply(this->left.evaluate(position), this->right.evaluate(position));
+        }
+    };
+
+    template <typename EXPR, typename OPERATION, bool SCALAR_FIRST, unsigned SIZE, typename TYPE>
+    class VecScalarExpression : public VecExpression<VecScalarExpression<EXPR, OPERATION, SCALAR_FIRST, SIZE, TYPE>, SIZE, TYPE> {
+
+        typename VecExpressionStorage<EXPR>::type expression;
+        const TYPE scalar;
+
+    public:
+
+        inline constexpr VecScalarExpression (const EXPR &_expression, const TYPE &_scalar) : expression(_expression), scalar(_scalar) {}
+
+        inline constexpr TYPE evaluate (unsigned position) const {
+            return SCALAR_FIRST ?
+                OPERATION::apply(this->scalar, this->expression.evaluate(position)) :
+                OPERATION::apply(this->expression.evaluate(position), this->scalar);
+        }
+    };
+
+    template <typename EXPR, unsigned SIZE, typename TYPE>
+    class VecNegateExpression : public VecExpression<VecNegateExpression<EXPR, SIZE, TYPE>, SIZE, TYPE> {
+
+        typename VecExpressionStorage<EXPR>::type expression;
+
+    public:
+
+        inline constexpr VecNegateExpression (const EXPR &_expression) : expression(_expression) {}
+
+        inline constexpr TYPE evaluate (unsigned position) const { return -this->expression.evaluate(position); }
+    };
+
+// -----------------------------------------------------------------------------
+
+#define MODULE_GRAPHICS_GEOMETRY_VEC_EXPRESSION_BINARY(OPERATOR, OPERATION) \
+    template <typename LEFT, typename RIGHT, unsigned SIZE, typename TYPE> \
+    inline constexpr VecBinaryExpression<LEFT, RIGHT, OPERATION, SIZE, TYPE> operator OPERATOR ( \
+        const VecExpression<LEFT, SIZE, TYPE> &left, \
+        const VecExpression<RIGHT, SIZE, TYPE> &right \
+    ) { return VecBinaryExpression<LEFT, RIGHT, OPERATION, SIZE, TYPE>(left.self(), right.self()); } \
+    \
+    template < \
+        typename EXPR, unsigned SIZE, typename TYPE, typename SCALAR, \
+        typename = typename std::enable_if<std::is_trivially_constructible<TYPE, SCALAR>::value, SCALAR>::type \
+    > \
+    inline constexpr VecScalarExpression<EXPR, OPERATION, false, SIZE, TYPE> operator OPERATOR ( \
+        const VecExpression<EXPR, SIZE, TYPE> &expression, \
+        const SCALAR &scalar \
+    ) { return VecScalarExpression<EXPR, OPERATION, false, SIZE, TYPE>(expression.self(), static_cast<TYPE>(scalar)); } \
+    \
+    template < \
+        typename EXPR, unsigned SIZE, typename TYPE, typename SCALAR, \
+        typename = typename std::enable_if<std::is_trivially_constructible<TYPE, SCALAR>::value, SCALAR>::type \
+    > \
+    inline constexpr VecScalarExpression<EXPR, OPERATION, true, SIZE, TYPE> operator OPERATOR ( \
+        const SCALAR &scalar, \
+        const VecExpression<EXPR, SIZE, TYPE> &expression \
+    ) { return VecScalarExpression<EXPR, OPERATION, true, SIZE, TYPE>(expression.self(), static_cast<TYPE>(scalar)); } \
+    \
+    template <unsigned SIZE, typename TYPE, typename RIGHT> \
+    inline VecBinaryExpression<VecValueExpression<SIZE, TYPE>, RIGHT, OPERATION, SIZE, TYPE> operator OPERATOR ( \
+        Vec<SIZE, TYPE> &&left, \
+        const VecExpression<RIGHT, SIZE, TYPE> &right \
+    ) { return VecBinaryExpression<VecValueExpression<SIZE, TYPE>, RIGHT, OPERATION, SIZE, TYPE>(VecValueExpression<SIZE, TYPE>(std::move(left)), right.self()); } \
+    \
+    template <typename LEFT, unsigned SIZE, typename TYPE> \
+    inline VecBinaryExpression<LEFT, VecValueExpression<SIZE, TYPE>, OPERATION, SIZE, TYPE> operator OPERATOR ( \
+        const VecExpression<LEFT, SIZE, TYPE> &left, \
+        Vec<SIZE, TYPE> &&right \
+    ) { return VecBinaryExpression<LEFT, VecValueExpression<SIZE, TYPE>, OPERATION, SIZE, TYPE>(left.self(), VecValueExpression<SIZE, TYPE>(std::move(right))); } \
+    \
+    template <unsigned SIZE, typename TYPE> \
+    inline VecBinaryExpression<VecValueExpression<SIZE, TYPE>, VecValueExpression<SIZE, TYPE>, OPERATION, SIZE, TYPE> operator OPERATOR ( \
+        Vec<SIZE, TYPE> &&left, \
+        Vec<SIZE, TYPE> &&right \
+    ) { return VecBinaryExpression<VecValueExpression<SIZE, TYPE>, VecValueExpression<SIZE, TYPE>, OPERATION, SIZE, TYPE>(VecValueExpression<SIZE, TYPE>(std::move(left)), VecValueExpression<SIZE, TYPE>(std::move(right))); } \
+    \
+    template < \
+        unsigned SIZE, typename TYPE, typename SCALAR, \
+        typename = typename std::enable_if<std::is_trivially_constructible<TYPE, SCALAR>::value, SCALAR>::type \
+    > \
+    inline VecScalarExpression<VecValueExpression<SIZE, TYPE>, OPERATION, false, SIZE, TYPE> operator OPERATOR ( \
+        Vec<SIZE, TYPE> &&vec, \
+        const SCALAR &scalar \
+    ) { return VecScalarExpression<VecValueExpression<SIZE, TYPE>, OPERATION, false, SIZE, TYPE>(VecValueExpression<SIZE, TYPE>(std::move(vec)), static_cast<TYPE>(scalar)); } \
+    \
+    template < \
+        unsigned SIZE, typename TYPE, typename SCALAR, \
+        typename = typename std::enable_if<std::is_trivially_constructible<TYPE, SCALAR>::value, SCALAR>::type \
+    > \
+    inline VecScalarExpression<VecValueExpression<SIZE, TYPE>, OPERATION, true, SIZE, TYPE> operator OPERATOR ( \
+        const SCALAR &scalar, \
+        Vec<SIZE, TYPE> &&vec \
+    ) { return VecScalarExpression<VecValueExpression<SIZE, TYPE>, OPERATION, true, SIZE, TYPE>(VecValueExpression<SIZE, TYPE>(std::move(vec)), static_cast<TYPE>(scalar)); }
+
+    MODULE_GRAPHICS_GEOMETRY_VEC_EXPRESSION_BINARY(+, VecOperation::Add)
+    MODULE_GRAPHICS_GEOMETRY_VEC_EXPRESSION_BINARY(-, VecOperation::Sub)
+    MODULE_GRAPHICS_GEOMETRY_VEC_EXPRESSION_BINARY(*, VecOperation::Mul)
+    MODULE_GRAPHICS_GEOMETRY_VEC_EXPRESSION_BINARY(/, VecOperation::Div)
+
+#undef MODULE_GRAPHICS_GEOMETRY_VEC_EXPRESSION_BINARY
+
+    template <typename EXPR, unsigned SIZE, typename TYPE>
+    inline constexpr VecNegateExpression<EXPR, SIZE, TYPE> operator - (const VecExpression<EXPR, SIZE, TYPE> &expression) {
+        return VecNegateExpression<EXPR, SIZE, TYPE>(expression.self());
+    }
+
+    template <unsigned SIZE, typename TYPE>
+    inline VecNegateExpression<VecValueExpression<SIZE, TYPE>, SIZE, TYPE> operator - (Vec<SIZE, TYPE> &&vec) {
+        return VecNegateExpression<VecValueExpression<SIZE, TYPE>, SIZE, TYPE>(VecValueExpression<SIZE, TYPE>(std::move(vec)));
+    }
+};
+
+#endif
@@ -0,0 +1,200 @@
+#ifndef MODULE_GRAPHICS_GEOMETRY_VEC_SIMD_H_
+#define MODULE_GRAPHICS_GEOMETRY_VEC_SIMD_H_
+
+#include <cstddef>
+#include "defaults.h"
+
+#if defined(__SSE2__) && !defined(MODULE_GRAPHICS_GEOMETRY_NO_SIMD)
+#define MODULE_GRAPHICS_GEOMETRY_VEC_SIMD
+#include <immintrin.h>
+#endif
+
+namespace Geometry {
+
+    // Raw kernels behind Vec::dot, length2, distance2 and cross.
+    // The generic version is a plain loop, Vec<3> and Vec<4> of float and double get SSE/AVX.
+    template <unsigned SIZE, typename TYPE>
+    struct VecKernel {
+
+        static constexpr std::size_t alignment = alignof(TYPE);
+
+        static inline TYPE dot (const TYPE *a, const TYPE *b) {
+            TYPE result = static_cast<TYPE>(0);
+            for (unsigned i = 0; i < SIZE; ++i) {
+                result += a[i] * b[i];
+            }
+            return result;
+        }
+
+        static inline TYPE distance2 (const TYPE *a, const TYPE *b) {
+            TYPE result = static_cast<TYPE>(0);
+            for (unsigned i = 0; i < SIZE; ++i) {
+                const TYPE diff = a[i] - b[i];
+                result += diff * diff;
+            }
+            return result;
+        }
+
+        static inline void cross (const TYPE *a, const TYPE *b, TYPE *out) {
+            out[0] = a[1] * b[2] - b[1] * a[2];
+            out[1] = a[2] * b[0] - b[2] * a[0];
+            out[2] = a[0] * b[1] - b[0] * a[1];
+        }
+    };
+
+#ifdef MODULE_GRAPHICS_GEOMETRY_VEC_SIMD
+
+    namespace Simd {
+
+        inline float horizontalSum (__m128 value) {
+            __m128 shuffled = _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1));
+            __m128 sums = _mm_add_ps(value, shuffled);
+            shuffled = _mm_movehl_ps(shuffled, sums);
+            return _mm_cvtss_f32(_mm_add_ss(sums, shuffled));
+        }
+
+        inline double horizontalSum (__m128d value) {
+            return _mm_cvtsd_f64(_mm_add_sd(value, _mm_unpackhi_pd(value, value)));
+        }
+
+        // { x, y, z, 0 } without reading past the third element. __m64 may alias anything, a double doesn't.
+        inline __m128 load3 (const float *values) {
+            const __m128 xy = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64 *>(values));
+            return _mm_movelh_ps(xy, _mm_load_ss(values + 2));
+        }
+
+        inline void store3 (float *values, __m128 value) {
+            _mm_storel_pi(reinterpret_cast<__m64 *>(values), value);
+            _mm_store_ss(values + 2, _mm_movehl_ps(value, value));
+        }
+
+        inline float dot3 (__m128 a, __m128 b) {
+#ifdef __SSE4_1__
+            return _mm_cvtss_f32(_mm_dp_ps(a, b, 0x71));
+#else
+            return horizontalSum(_mm_mul_ps(a, b));
+#endif
+        }
+
+        inline float dot4 (__m128 a, __m128 b) {
+#ifdef __SSE4_1__
+            return _mm_cvtss_f32(_mm_dp_ps(a, b, 0xF1));
+#else
+            return horizontalSum(_mm_mul_ps(a, b));
+#endif
+        }
+    };
+
+    template <>
+    struct VecKernel<3, float> {
+
+        static constexpr std::size_t alignment = alignof(float);
+
+        static inline float dot (const float *a, const float *b) {
+            return Simd::dot3(Simd::load3(a), Simd::load3(b));
+        }
+
+        static inline float distance2 (const float *a, const float *b) {
+            const __m128 diff = _mm_sub_ps(Simd::load3(a), Simd::load3(b));
+            return Simd::dot3(diff, diff);
+        }
+
+        static inline void cross (const float *a, const float *b, float *out) {
+            const __m128
+                va = Simd::load3(a), vb = Simd::load3(b),
+                a_yzx = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 0, 2, 1)),
+                b_yzx = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 0, 2, 1)),
+                c = _mm_sub_ps(_mm_mul_ps(va, b_yzx), _mm_mul_ps(a_yzx, vb));
+            Simd::store3(out, _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1)));
+        }
+    };
+
+    template <>
+    struct VecKernel<4, float> {
+
+        static constexpr std::size_t alignment = 16;
+
+        static inline float dot (const float *a, const float *b) {
+            return Simd::dot4(_mm_loadu_ps(a), _mm_loadu_ps(b));
+        }
+
+        static inline float distance2 (const float *a, const float *b) {
+            const __m128 diff = _mm_sub_ps(_mm_loadu_ps(a), _mm_loadu_ps(b));
+            return Simd::dot4(diff, diff);
+        }
+
+        static inline void cross (const float *a, const float *b, float *out) { VecKernel<3, float>::cross(a, b, out); }
+    };
+
+    template <>
+    struct VecKernel<3, double> {
+
+        static constexpr std::size_t alignment = alignof(double);
+
+        static inline double dot (const double *a, const double *b) {
+            const __m128d xy = _mm_mul_pd(_mm_loadu_pd(a), _mm_loadu_pd(b));
+            return Simd::horizontalSum(_mm_add_sd(xy, _mm_mul_sd(_mm_load_sd(a + 2), _mm_load_sd(b + 2))));
+        }
+
+        static inline double distance2 (const double *a, const double *b) {
+            const __m128d
+                xy = _mm_sub_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)),
+                z = _mm_sub_sd(_mm_load_sd(a + 2), _mm_load_sd(b + 2));
+            return Simd::horizontalSum(_mm_add_sd(_mm_mul_pd(xy, xy), _mm_mul_sd(z, z)));
+        }
+
+        // x and y are computed together as { a1, a2 } * { b2, b0 } - { a2, a0 } * { b1, b2 }
+        static inline void cross (const double *a, const double *b, double *out) {
+            const __m128d
+                a12 = _mm_loadu_pd(a + 1), b12 = _mm_loadu_pd(b + 1),
+                a20 = _mm_shuffle_pd(a12, _mm_load_sd(a), 0x1),
+                b20 = _mm_shuffle_pd(b12, _mm_load_sd(b), 0x1);
+            _mm_storeu_pd(out, _mm_sub_pd(_mm_mul_pd(a12, b20), _mm_mul_pd(a20, b12)));
+            out[2] = a[0] * b[1] - b[0] * a[1];
+        }
+    };
+
+    template <>
+    struct VecKernel<4, double> {
+
+        static constexpr std::size_t alignment = 16;
+
+#ifdef __AVX__
+        static inline double sum (__m256d value) {
+            return Simd::horizontalSum(_mm_add_pd(_mm256_castpd256_pd128(value), _mm256_extractf128_pd(value, 1)));
+        }
+
+        static inline double dot (const double *a, const double *b) {
+            return sum(_mm256_mul_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b)));
+        }
+
+        static inline double distance2 (const double *a, const double *b) {
+            const __m256d diff = _mm256_sub_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b));
+            return sum(_mm256_mul_pd(diff, diff));
+        }
+#else
+        static inline double dot (const double *a, const double *b) {
+            const __m128d
+                xy = _mm_mul_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)),
+                zw = _mm_mul_pd(_mm_loadu_pd(a + 2), _mm_loadu_pd(b + 2));
+            return Simd::horizontalSum(_mm_add_pd(xy, zw));
+        }
+
+        static inline double distance2 (const double *a, const double *b) {
+            const __m128d
+                xy = _mm_sub_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)),
+                zw = _mm_sub_pd(_mm_loadu_pd(a + 2), _mm_loadu_pd(b + 2));
+            return Simd::horizontalSum(_mm_add_pd(_mm_mul_pd(xy, xy), _mm_mul_pd(zw, zw)));
+        }
+#endif
+
+        static inline void cross (const double *a, const double *b, double *out) { VecKernel<3, double>::cross(a, b, out); }
+    };
+
+#endif
+
+    template <unsigned SIZE, typename TYPE>
+    constexpr std::size_t VecKernel<SIZE, TYPE>::alignment;
+};
+
+#endif